@@ -1,7 +1,9 @@
 """fx_cli Python package
 
 This package exposes the high level FX motor controller client to Python.
-It re-exports the C++ class `FxCli` from the compiled module `fx_cli`.
+It re-exports the C++ class `FxCli` from the compiled module `fx_cli`,
+together with the in-process simulator `FxSim`, its base type `FxTransport`
+and the span tracing functions (`trace_*`).
 
 Usage:
 
@@ -12,6 +14,28 @@ Usage:
 
 """
 
-from .fx_cli import FxCli
+from .fx_cli import (
+    FxCli,
+    FxSim,
+    FxTransport,
+    trace_enable,
+    trace_enabled,
+    trace_clear,
+    trace_set_buffer_capacity,
+    trace_dropped,
+    trace_json,
+    trace_dump,
+)
 
-__all__ = ["FxCli"]
+__all__ = [
+    "FxCli",
+    "FxSim",
+    "FxTransport",
+    "trace_enable",
+    "trace_enabled",
+    "trace_clear",
+    "trace_set_buffer_capacity",
+    "trace_dropped",
+    "trace_json",
+    "trace_dump",
+]
@@ -0,0 +1,345 @@
+// fx_cli_bench.cpp
+//
+// Microbenchmarks for the FX CLI protocol hot paths.
+// Measures ns/op and C++ heap allocations/op for encoding (format_float,
+// build_id_group, AT+MIT), reply matching (extract_tag_word/upper_copy/
+// ReplyRouter round trip at several backlog/in-flight depths), one trace span
+// (disabled/enabled) and reply parsing
+// (FxReply::parse alone and parse_response_string → Python dict on REQ/STATUS
+// payloads for 4/8/16 motors).
+//
+// Usage:
+//   fx_cli_bench [--json] [--filter <substr>] [--min-time-ms <ms>] [--reps <n>]
+//
+// Inputs are fixed, so runs are comparable between commits:
+//   fx_cli_bench --json > before.json   (checkout / rebuild)
+//   fx_cli_bench --json > after.json
+
+#include <pybind11/embed.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "fx_mit_delta.h"
+#include "fx_protocol.h"
+#include "fx_reply.h"
+#include "fx_reply_router.h"
+#include "fx_trace.h"
+#include "py_reply.h"
+
+// ──────────────────────────
+// Allocation counting (global operator new)
+// ──────────────────────────
+static std::atomic<uint64_t> g_alloc_count{0};
+static std::atomic<uint64_t> g_alloc_bytes{0};
+
+void *operator new(std::size_t n) {
+    g_alloc_count.fetch_add(1, std::memory_order_relaxed);
+    g_alloc_bytes.fetch_add(n, std::memory_order_relaxed);
+    if (void *p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void *operator new[](std::size_t n) { return operator new(n); }
+// noinline: GCC 가 new/free 짝을 인라인 분석하여 내는 -Wmismatched-new-delete 오탐 방지
+__attribute__((noinline)) void operator delete(void *p) noexcept { std::free(p); }
+__attribute__((noinline)) void operator delete[](void *p) noexcept { std::free(p); }
+__attribute__((noinline)) void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+__attribute__((noinline)) void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+
+// 최적화로 측정 대상이 제거되지 않도록 결과를 흘려보내는 곳
+static volatile size_t g_sink = 0;
+static inline void sink(size_t v) { g_sink = g_sink + v; }
+
+// ──────────────────────────
+// Runner
+// ──────────────────────────
+struct BenchResult {
+    std::string name;
+    uint64_t iters;         // 1회 반복(rep)당 호출 수
+    double ns_per_op;       // rep 중앙값
+    double ns_min;
+    double allocs_per_op;
+    double bytes_per_op;
+};
+
+struct BenchOptions {
+    bool json = false;
+    std::string filter;
+    double min_time_ms = 50.0;
+    int reps = 5;
+};
+
+using Clock = std::chrono::steady_clock;
+
+static double run_batch(const std::function<void()> &fn, uint64_t iters) {
+    auto t0 = Clock::now();
+    for (uint64_t i = 0; i < iters; ++i) fn();
+    auto t1 = Clock::now();
+    return std::chrono::duration<double, std::nano>(t1 - t0).count();
+}
+
+static BenchResult run_bench(const std::string &name,
+                             const std::function<void()> &fn,
+                             const BenchOptions &opt) {
+    // 워밍업 + 반복 횟수 보정: 한 rep 이 min_time_ms 이상 걸리도록
+    uint64_t iters = 1;
+    for (;;) {
+        double ns = run_batch(fn, iters);
+        if (ns >= opt.min_time_ms * 1e6 || iters >= (1ull << 30)) break;
+        double scale = (ns > 0.0) ? (opt.min_time_ms * 1e6 * 1.2) / ns : 10.0;
+        iters = static_cast<uint64_t>(iters * std::min(std::max(scale, 2.0), 100.0));
+    }
+
+    std::vector<double> per_op;
+    per_op.reserve(opt.reps);
+    for (int r = 0; r < opt.reps; ++r)
+        per_op.push_back(run_batch(fn, iters) / static_cast<double>(iters));
+    std::sort(per_op.begin(), per_op.end());
+
+    // 할당 수는 결정적이므로 별도 패스에서 한 번만 집계
+    const uint64_t alloc_iters = std::min<uint64_t>(iters, 10000);
+    uint64_t c0 = g_alloc_count.load(), b0 = g_alloc_bytes.load();
+    run_batch(fn, alloc_iters);
+    uint64_t c1 = g_alloc_count.load(), b1 = g_alloc_bytes.load();
+
+    BenchResult res;
+    res.name = name;
+    res.iters = iters;
+    res.ns_per_op = per_op[per_op.size() / 2];
+    res.ns_min = per_op.front();
+    res.allocs_per_op = static_cast<double>(c1 - c0) / alloc_iters;
+    res.bytes_per_op = static_cast<double>(b1 - b0) / alloc_iters;
+    return res;
+}
+
+// ──────────────────────────
+// Fixed payloads
+// ──────────────────────────
+static std::vector<uint8_t> make_ids(size_t n) {
+    std::vector<uint8_t> ids(n);
+    for (size_t i = 0; i < n; ++i) ids[i] = static_cast<uint8_t>(i + 1);
+    return ids;
+}
+
+static std::vector<float> make_values(size_t n, float base, float step) {
+    std::vector<float> v(n);
+    for (size_t i = 0; i < n; ++i) v[i] = base + step * static_cast<float>(i);
+    return v;
+}
+
+// "OK <REQ>;M1:p:..., v:..., t:...;...;IMU:...;SEQ_NUM:cnt:...;"
+static std::string make_req_reply(size_t motors) {
+    std::string s = "OK <REQ>;";
+    char buf[128];
+    for (size_t i = 0; i < motors; ++i) {
+        std::snprintf(buf, sizeof(buf), "M%zu:p:%.6f, v:%.6f, t:%.6f;",
+                      i + 1, 5.149729 - 0.731 * i, 1.217365 - 0.113 * i, -0.021057 + 0.007 * i);
+        s += buf;
+    }
+    s += "IMU:r:-0.35, p:0.31, y:-14.61, gx:0.00, gy:0.00, gz:0.00, "
+         "pgx:0.00, pgy:0.00, pgz:1.00;";
+    s += "SEQ_NUM:cnt:183510;";
+    return s;
+}
+
+// "OK <STATUS>;MCU:fw:1.1.0, proto:ATv1, uptime:...;NET:up, ip:...;..."
+static std::string make_status_reply(size_t motors) {
+    std::string s = "OK <STATUS>;";
+    s += "MCU:fw:1.1.0, proto:ATv1, uptime:81845;";
+    s += "NET:up, ip:192.168.10.10, gw:192.168.10.1, mask:255.255.255.0;";
+    s += "QUEUE:udp_tx:0, motor_ctrl:0;";
+    s += "CAN1:Err:0x00000100, LEC:3, ACT:24, EP:0, BO:0, REC:0, TEC:62, TXFE:7, RX0:0, RX1:0;";
+    s += "CAN2:Err:0x00000300, LEC:0, ACT:16, EP:0, BO:0, REC:0, TEC:7, TXFE:8, RX0:0, RX1:0;";
+    char buf[64];
+    for (size_t i = 0; i < motors; ++i) {
+        std::snprintf(buf, sizeof(buf), "M%zu:pattern:2, err:None;", i + 1);
+        s += buf;
+    }
+    s += "IMU:pattern:2, err:None;";
+    s += "EMERGENCY:OFF;";
+    return s;
+}
+
+// ──────────────────────────
+// Output
+// ──────────────────────────
+static void print_table(const std::vector<BenchResult> &rs) {
+    std::printf("%-40s %14s %12s %12s %12s\n",
+                "benchmark", "iters", "ns/op", "allocs/op", "bytes/op");
+    for (const auto &r : rs) {
+        std::printf("%-40s %14llu %12.1f %12.2f %12.1f\n",
+                    r.name.c_str(), (unsigned long long)r.iters,
+                    r.ns_per_op, r.allocs_per_op, r.bytes_per_op);
+    }
+}
+
+static void print_json(const std::vector<BenchResult> &rs, const BenchOptions &opt) {
+    std::printf("{\n  \"context\": {\"reps\": %d, \"min_time_ms\": %.1f, "
+                "\"allocs\": \"C++ operator new only\"},\n", opt.reps, opt.min_time_ms);
+    std::printf("  \"benchmarks\": [\n");
+    for (size_t i = 0; i < rs.size(); ++i) {
+        const auto &r = rs[i];
+        std::printf("    {\"name\": \"%s\", \"iters\": %llu, \"ns_per_op\": %.3f, "
+                    "\"ns_min\": %.3f, \"allocs_per_op\": %.3f, \"bytes_per_op\": %.3f}%s\n",
+                    r.name.c_str(), (unsigned long long)r.iters, r.ns_per_op,
+                    r.ns_min, r.allocs_per_op, r.bytes_per_op,
+                    (i + 1 < rs.size()) ? "," : "");
+    }
+    std::printf("  ]\n}\n");
+}
+
+static bool parse_args(int argc, char **argv, BenchOptions &opt) {
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a == "--json") opt.json = true;
+        else if (a == "--filter" && i + 1 < argc) opt.filter = argv[++i];
+        else if (a == "--min-time-ms" && i + 1 < argc) opt.min_time_ms = std::atof(argv[++i]);
+        else if (a == "--reps" && i + 1 < argc) opt.reps = std::max(1, std::atoi(argv[++i]));
+        else {
+            std::fprintf(stderr,
+                "usage: %s [--json] [--filter <substr>] [--min-time-ms <ms>] [--reps <n>]\n",
+                argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    BenchOptions opt;
+    if (!parse_args(argc, argv, opt)) return 2;
+
+    py::scoped_interpreter guard{};
+
+    std::vector<BenchResult> results;
+    auto add = [&](const std::string &name, const std::function<void()> &fn) {
+        if (!opt.filter.empty() && name.find(opt.filter) == std::string::npos) return;
+        results.push_back(run_bench(name, fn, opt));
+        if (!opt.json)
+            std::fprintf(stderr, "  done: %s\n", name.c_str());
+    };
+
+    const size_t motor_counts[] = {4, 8, 16};
+
+    // ---- 인코딩 ----
+    add("format_float/zero", [] { sink(fx_proto::format_float(0.0f).size()); });
+    add("format_float/typical", [] { sink(fx_proto::format_float(5.149729f).size()); });
+    add("format_float/negative", [] { sink(fx_proto::format_float(-0.021057f).size()); });
+
+    for (size_t n : motor_counts) {
+        auto ids = make_ids(n);
+        add("build_id_group/" + std::to_string(n),
+            [ids] { sink(fx_proto::build_id_group(ids).size()); });
+    }
+
+    for (size_t n : motor_counts) {
+        auto ids = make_ids(n);
+        auto pos = make_values(n, 0.5f, 0.125f);
+        auto vel = make_values(n, 1.0f, -0.25f);
+        auto kp  = make_values(n, 20.0f, 0.0f);
+        auto kd  = make_values(n, 0.1f, 0.0f);
+        auto tau = make_values(n, 0.0f, 0.015625f);
+        add("encode_mit/" + std::to_string(n), [=] {
+            sink(fx_proto::encode_mit(ids, pos, vel, kp, kd, tau).size());
+        });
+
+        // 게인 고정, 위치만 변하는 스트리밍 (refresh 없음)
+        auto delta = std::make_shared<FxMitDelta>();
+        delta->configure(true, 0);
+        add("encode_mit_delta/" + std::to_string(n), [=]() mutable {
+            for (auto &p : pos) p += 0.001f;
+            sink(delta->encode(ids, pos, vel, kp, kd, tau).size());
+        });
+    }
+
+    // ---- 응답 매칭 ----
+    const std::string req16 = make_req_reply(16);
+    add("upper_copy/req16", [&] { sink(fx_proto::upper_copy(req16).size()); });
+    add("extract_tag_word/req16", [&] {
+        std::string tag;
+        sink(fx_proto::extract_tag_word(req16, tag) ? tag.size() : 0);
+    });
+
+    add("ok_tag_upper/req16", [&] {
+        std::string tag;
+        sink(fx_proto::ok_tag_upper(req16, tag) ? tag.size() : 0);
+    });
+
+    // 요청 1회 경로: expect(등록) → dispatch(RX 스레드 분배) → await(수령)
+    // - backlog=D : 대기자 없는 패킷 D 개가 쌓인 상태 (매칭 비용과 무관해야 함)
+    // - inflight=N: 다른 TAG 로 대기 중인 요청 N 개
+    const std::string req4 = make_req_reply(4);
+    for (size_t depth : {0, 16, 64, 256}) {
+        auto router = std::make_shared<fx_proto::ReplyRouter>(256);
+        for (size_t i = 0; i < depth; ++i)
+            router->dispatch({make_status_reply(4), Clock::now()});
+        add("reply_router/roundtrip/backlog=" + std::to_string(depth), [router, &req4] {
+            auto t = router->expect("REQ");
+            router->dispatch({req4, Clock::now()});
+            fx_proto::RxPacket out;
+            sink(router->await(t, out, 0) ? out.data.size() : 0);
+        });
+    }
+    for (size_t n : {1, 16, 64}) {
+        auto router = std::make_shared<fx_proto::ReplyRouter>(256);
+        std::vector<fx_proto::ReplyRouter::Ticket> others;
+        for (size_t i = 0; i < n; ++i)
+            others.push_back(router->expect("T" + std::to_string(i)));
+        add("reply_router/roundtrip/inflight=" + std::to_string(n), [router, &req4] {
+            auto t = router->expect("REQ");
+            router->dispatch({req4, Clock::now()});
+            fx_proto::RxPacket out;
+            sink(router->await(t, out, 0) ? out.data.size() : 0);
+        });
+    }
+
+    // ---- 트레이싱 span 1개 비용 (비활성 = 계측 지점의 기본 오버헤드) ----
+    add("trace_span/disabled", [] {
+        fx_trace::enable(false);
+        FX_TRACE_SPAN(bench);
+        sink(1);
+    });
+    add("trace_span/enabled", [] {
+        fx_trace::enable(true);
+        { FX_TRACE_SPAN(bench); sink(1); }
+        fx_trace::enable(false);
+    });
+
+    // ---- 응답 파싱 (C++ 트리) ----
+    for (size_t n : motor_counts) {
+        std::string req = make_req_reply(n);
+        add("fx_reply_parse/req/" + std::to_string(n),
+            [req] { sink(FxReply::parse(req).segments().size()); });
+    }
+    for (size_t n : motor_counts) {
+        std::string st = make_status_reply(n);
+        add("fx_reply_parse/status/" + std::to_string(n),
+            [st] { sink(FxReply::parse(st).segments().size()); });
+    }
+
+    // ---- 응답 파싱 (Python dict) ----
+    for (size_t n : motor_counts) {
+        std::string req = make_req_reply(n);
+        add("parse_response_string/req/" + std::to_string(n),
+            [req] { sink(parse_response_string(req).size()); });
+    }
+    for (size_t n : motor_counts) {
+        std::string st = make_status_reply(n);
+        add("parse_response_string/status/" + std::to_string(n),
+            [st] { sink(parse_response_string(st).size()); });
+    }
+
+    if (opt.json) print_json(results, opt);
+    else          print_table(results);
+    return 0;
+}
@@ -0,0 +1,53 @@
+import fx_cli
+import time
+"""
+Example usage of the in-process MCU simulator.
+
+FxCli talks to FxSim through the same command/reply path it uses on hardware,
+but without sockets or threads; physics only advances on sim.step(), so a
+policy loop runs deterministically and as fast as the CPU allows.
+"""
+
+ids_specific = [1, 2, 3, 4]
+n = len(ids_specific)
+
+sim = fx_cli.FxSim(dt=0.001)
+for i in ids_specific:
+    sim.add_motor(i, inertia=0.01, damping=0.02, tau_max=10.0)
+
+cli = fx_cli.FxCli(sim)
+
+try:
+    if not cli.motor_start(ids_specific):
+        print("Motor start failed")
+
+    steps = 5000
+    target = 1.0
+    t0 = time.perf_counter()
+    for k in range(steps):
+        obs = cli.req(ids_specific)
+        # 간단한 정책: 목표 위치로 PD
+        cli.operation_control([{"id": i, "pos": target, "vel": 0.0, "kp": 20.0, "kd": 1.0, "tau": 0.0}
+                               for i in ids_specific])
+        sim.step()
+    elapsed = time.perf_counter() - t0
+
+    print("sim time: %.3f s, wall: %.3f s (%.0f steps/s)" % (sim.time(), elapsed, steps / elapsed))
+    print("M1:", cli.req(ids_specific)["M1"])
+
+    if not cli.motor_stop(ids_specific):
+        print("Motor stop failed")
+
+    # 응답 유실 복구: REQ 응답 1건을 버린 뒤 다음 요청부터는 정상 매칭되어야 함
+    sim.drop_replies("REQ", 1)
+    lost = cli.req(ids_specific)
+    failed = sum(1 for _ in range(100) if not cli.req(ids_specific))
+    print("REQ after dropped reply: %d/100 failed" % failed)
+    if lost or failed:
+        raise SystemExit("reply loss was not contained to the dropped request")
+
+    # 에피소드 리셋
+    sim.reset()
+
+except Exception as e:
+    print("Error during simulation flow:", e)
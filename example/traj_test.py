@@ -0,0 +1,50 @@
+import fx_cli
+import math
+import time
+"""
+Example usage of the FX CLI trajectory streamer.
+
+Waypoints are uploaded from Python at a low rate, while the C++ streamer
+inside FxCli interpolates them and sends AT+MIT setpoints at 1 kHz.
+"""
+
+cli = fx_cli.FxCli("192.168.10.10", 5101)
+
+ids_specific = [1, 2, 3, 4]
+n = len(ids_specific)
+
+def waypoint(t, pos, vel):
+    return {"t": t,
+            "pos": [pos] * n, "vel": [vel] * n,
+            "kp": [10.0] * n, "kd": [0.5] * n, "tau": [0.0] * n}
+
+try:
+    if not cli.motor_start(ids_specific):
+        print("Motor start failed")
+
+    # 1 kHz, 3차 Hermite 보간
+    cli.traj_start(ids_specific, rate_hz=1000.0, interp="cubic")
+
+    # 0.5 s 간격 사인 궤적 (pos/vel 접선 일치)
+    A, w, dt = 0.5, 2.0 * math.pi * 0.5, 0.5
+    cli.traj_load([waypoint(k * dt, A * math.sin(w * k * dt), A * w * math.cos(w * k * dt))
+                   for k in range(4)])
+
+    # 실행 중 원자적으로 이어 붙이기
+    T = 5
+    k = 4
+    while k * dt < T:
+        time.sleep(dt)
+        cli.traj_load([waypoint(k * dt, A * math.sin(w * k * dt), A * w * math.cos(w * k * dt))],
+                      append=True)
+        k += 1
+
+    time.sleep(1.0)
+    cli.traj_stop()
+    print("traj stats:", cli.traj_stats())
+
+    if not cli.motor_stop(ids_specific):
+        print("Motor stop failed")
+
+except Exception as e:
+    print("Error during trajectory flow:", e)
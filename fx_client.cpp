@@ -5,6 +5,11 @@
 #endif
 
 #include "fx_client.h"
+#include "fx_protocol.h"
+#include "fx_clock_sync.h"
+#include "fx_mit_delta.h"
+#include "fx_reply_router.h"
+#include "fx_trace.h"
 #include "utils/elapsed_timer.h"
 
 #include <cstring>
@@ -20,131 +25,87 @@
 #include <deque>
 #include <atomic>
 #include <vector>
+#include <map>
+#include <memory>
+#include <algorithm>
 
 #include <arpa/inet.h>
 #include <netinet/in.h>
+#include <netinet/ip.h>
+#include <poll.h>
 #include <sys/socket.h>
 #include <unistd.h>
 #include <sys/select.h>
 #include <sys/time.h>
 #include <sys/types.h>
+#include <pthread.h>
+#include <sched.h>
 
 #ifdef DEBUG
 static ElapsedTimer g_timer_ack("chk_ACK");
 #endif
 
 // ========= 내부 유틸 =========
+using fx_proto::upper_copy;
+using fx_proto::build_id_group;
+
 namespace {
 
-static inline void trim(std::string &s) {
-    size_t b = s.find_first_not_of(" \t\r\n");
-    if (b == std::string::npos) { s.clear(); return; }
-    size_t e = s.find_last_not_of(" \t\r\n");
-    s.assign(s, b, e - b + 1);
-}
+// ip:port 로 connect() 된 UDP 소켓 생성 (실패 시 예외)
+int open_connected_udp(const std::string &ip, uint16_t port, int rcvbuf,
+                       struct sockaddr_in &addr) {
+    int s = ::socket(AF_INET, SOCK_DGRAM, 0);
+    if (s < 0) throw std::runtime_error("socket() failed");
 
-static inline std::string upper_copy(std::string s) {
-    for (char &c : s)
-        c = static_cast<char>(::toupper(static_cast<unsigned char>(c)));
-    return s;
-}
+    ::setsockopt(s, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
 
-// "OK <TAG>; ..." 혹은 "OK <TAG> ..." 에서 <TAG> 추출
-static bool extract_tag_word(const std::string &resp, std::string &out_word) {
-    auto l = resp.find('<');
-    auto r = resp.find('>');
-    if (l == std::string::npos || r == std::string::npos || r <= l + 1) return false;
-    std::string inside = resp.substr(l + 1, r - l - 1);
-    trim(inside);
-    if (inside.empty()) return false;
-    size_t cut = inside.find_first_of(" \t(");
-    out_word = (cut == std::string::npos) ? inside : inside.substr(0, cut);
-    trim(out_word);
-    return !out_word.empty();
-}
-
-// OK 응답 검증 (단발용, 유지)
-static void verify_ack_or_throw(const std::string &resp, const char *expect_tag) {
-    if (resp.empty()) throw std::runtime_error("Timeout or empty reply from MCU");
-
-    std::string s = resp;
-    trim(s);
-    std::string su = upper_copy(s);
-    if (su.rfind("OK", 0) != 0)
-        throw std::runtime_error("Unexpected reply (no OK): " + s);
-
-    std::string tag;
-    if (!extract_tag_word(s, tag))
-        throw std::runtime_error("Missing <TAG> in reply: " + s);
-
-    if (upper_copy(tag) != upper_copy(expect_tag))
-        throw std::runtime_error("ACK TAG mismatch: expected '" +
-                                 std::string(expect_tag) + "' got '" + tag + "'");
-}
-
-// float -> 문자열 변환
-static std::string format_float(float v) {
-    std::ostringstream ss;
-    ss << std::setprecision(6) << std::fixed << v;
-    std::string s = ss.str();
-    size_t pos = s.find_last_not_of('0');
-    if (pos != std::string::npos) {
-        if (s[pos] == '.') s.erase(pos + 2);
-        else s.erase(pos + 1);
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port   = htons(port);
+    if (::inet_pton(AF_INET, ip.c_str(), &addr.sin_addr) != 1) {
+        ::close(s);
+        throw std::runtime_error("inet_pton failed");
     }
-    return s;
-}
-
-// ID 그룹 빌드
-static std::string build_id_group(const std::vector<uint8_t> &ids) {
-    std::ostringstream oss;
-    oss << '<';
-    for (size_t i = 0; i < ids.size(); ++i) {
-        if (i) oss << ' ';
-        oss << static_cast<unsigned>(ids[i]);
+    if (::connect(s, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) < 0) {
+        ::close(s);
+        throw std::runtime_error("connect() failed");
     }
-    oss << '>';
-    return oss.str();
+    return s;
 }
 
 } // namespace
 
-// ========= UDP 소켓 + RX 스레드/링버퍼 =========
-class FxCli::UdpSocket {
+// ========= UDP 전송 (기본 FxTransport) =========
+namespace {
+
+class UdpTransport : public FxTransport {
 public:
-    struct RxPacket {
-        std::string data;
-        std::chrono::steady_clock::time_point t_arrival;
-    };
+    // 기본값: 넉넉한 수신 버퍼(1MB, 버스트 대비), 일반 스케줄링
+    UdpTransport(const std::string &ip, uint16_t port,
+                 const FxChannelOptions &opt = FxChannelOptions{})
+    : rx_priority_(opt.rx_priority) {
+        sock_ = open_connected_udp(ip, port, opt.rcvbuf, addr_);
+        if (opt.so_priority > 0)
+            ::setsockopt(sock_, SOL_SOCKET, SO_PRIORITY, &opt.so_priority, sizeof(opt.so_priority));
+    }
 
-    UdpSocket(const std::string &ip, uint16_t port, size_t max_queue = 256)
-    : max_queue_(max_queue)
-    {
-        sock_ = ::socket(AF_INET, SOCK_DGRAM, 0);
-        if (sock_ < 0) throw std::runtime_error("socket() failed");
-
-        // 넉넉한 수신 버퍼(버스트 대비)
-        int rcvbuf = 1 << 20; // 1MB
-        ::setsockopt(sock_, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
-
-        std::memset(&addr_, 0, sizeof(addr_));
-        addr_.sin_family = AF_INET;
-        addr_.sin_port   = htons(port);
-        if (::inet_pton(AF_INET, ip.c_str(), &addr_.sin_addr) != 1) {
-            close_socket(sock_);
-            throw std::runtime_error("inet_pton failed");
-        }
-        if (::connect(sock_, reinterpret_cast<struct sockaddr *>(&addr_), sizeof(addr_)) < 0) {
-            close_socket(sock_);
-            throw std::runtime_error("connect() failed");
-        }
+    ~UdpTransport() override {
+        stop();
+    }
 
+    void start(RxFn on_rx) override {
+        on_rx_ = std::move(on_rx);
         // Rx 스레드 시작
         run_rx_.store(true);
         rx_thread_ = std::thread([this]{ this->rx_loop_blocking(); });
     }
 
-    ~UdpSocket() {
+    void send(const char *data, size_t len) override {
+        ssize_t n = ::send(sock_, data, (int)len, 0);
+        if (n < 0 || (size_t)n != len) throw std::runtime_error("send() failed");
+    }
+
+    void stop() override {
         run_rx_.store(false);
 
         if (sock_ >= 0) {
@@ -158,123 +119,311 @@ public:
         }
     }
 
+private:
+    int sock_{-1};
+    struct sockaddr_in addr_{};
+    int rx_priority_ = 0;
+
+    std::atomic<bool> run_rx_{false};
+    std::thread rx_thread_;
+    RxFn on_rx_;
+
+    void rx_loop_blocking() {
+        if (rx_priority_ > 0) {
+            struct sched_param sp{};
+            sp.sched_priority = rx_priority_;
+            ::pthread_setschedparam(::pthread_self(), SCHED_FIFO, &sp);   // 실패 시 일반 스케줄링 유지
+        }
+
+        // 블로킹 recv 루프
+        while (run_rx_.load()) {
+            char buf[1024];
+            ssize_t n = ::recv(sock_, buf, sizeof(buf) - 1, 0);
+            if (n <= 0) {
+                // 소켓 종료/에러 시 잠깐 쉼
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                continue;
+            }
+            buf[n] = '\0';
+
+            on_rx_(std::string(buf, (size_t)n), std::chrono::steady_clock::now());
+        }
+    }
+};
+
+} // namespace
+
+// ========= 송신 직렬화 + 응답 분배 (전송 계층과 무관) =========
+class FxCli::UdpSocket {
+public:
+    using RxPacket = fx_proto::RxPacket;
+    using Ticket   = fx_proto::ReplyRouter::Ticket;
+
+    explicit UdpSocket(std::shared_ptr<FxTransport> transport, size_t max_queue = 256)
+    : transport_(std::move(transport)),
+      router_(max_queue)
+    {
+        if (!transport_) throw std::invalid_argument("transport must not be null");
+        transport_->start([this](std::string &&data, std::chrono::steady_clock::time_point t) {
+            FX_TRACE_SPAN(rx_dispatch);
+            RxPacket pkt;
+            pkt.data = std::move(data);
+            pkt.t_arrival = t;
+            router_.dispatch(std::move(pkt));
+        });
+    }
+
+    ~UdpSocket() {
+        transport_->stop();
+    }
+
     void send(const char *data, size_t len) {
-        ssize_t n = ::send(sock_, data, (int)len, 0);
-        if (n < 0 || (size_t)n != len) throw std::runtime_error("send() failed");
+        transport_->send(data, len);
+    }
+
+    // 응답 대기 등록 + 송신 (등록 순서 == 송신 순서 보장)
+    Ticket send_expect(const std::string& expect_tag_upper, const std::string& cmd) {
+        std::lock_guard<std::mutex> lk(tx_m_);
+        Ticket t = router_.expect(expect_tag_upper);
+        try {
+            send(cmd.c_str(), cmd.size());
+        } catch (...) {
+            router_.cancel(t);
+            throw;
+        }
+        return t;
     }
 
-    // ---- 큐 유틸 ----
+    // 등록한 티켓의 OK <TAG>; ... 패킷이 올 때까지 대기
+    bool wait_for_ok_tag(const Ticket& t, RxPacket& out_ok, int timeout_ms) {
+        return router_.await(t, out_ok, timeout_ms);
+    }
+
+    // ---- 큐 유틸 (대기자 없던 패킷) ----
     void flush_queue() {
+        router_.flush_backlog();
+    }
+
+    // 아무 패킷이나 하나(가장 최근) 대기 - 태그 검증 없이
+    bool wait_for_any(std::string& out, int timeout_ms) {
+        return router_.wait_for_any(out, timeout_ms);
+    }
+
+private:
+    std::shared_ptr<FxTransport> transport_;
+    std::mutex tx_m_;
+    fx_proto::ReplyRouter router_;
+};
+
+// ========= 안전 명령(ESTOP/STOP) 전용 우선 송신 경로 =========
+// - 예약 소켓: 일반 I/O 소켓/RX 스레드/ReplyRouter 와 완전히 분리 → 제어/텔레메트리 트래픽 뒤에 줄서지 않음
+//   (MCU 는 송신 포트로 ACK 를 돌려주므로 ACK 도 이 소켓으로만 수신)
+// - ID 조합별 명령 문자열을 미리 인코딩해 두고 호출 시 즉시 send()
+// - 락(m_)은 인코딩 조회 + send() + 통계 갱신 동안만 보유 → STOP 이 ACK 를 기다리는 중에도 ESTOP 즉시 송신
+// - ACK 대기: TAG(STOP/ESTOP)별 대기자 FIFO, 대기 중인 스레드 하나가 poll()/recv() 를 맡아
+//   받은 ACK 를 해당 TAG 의 가장 오래된 대기자에게 전달 (나머지는 조건변수 대기)
+// - 미수신 시 주기적으로 재송신 (ESTOP/STOP 은 멱등)
+// - 소켓 우선순위(SO_PRIORITY) + DSCP EF 마킹
+class FxCli::SafetyLane {
+public:
+    SafetyLane(const std::string &ip, uint16_t port) {
+        struct sockaddr_in addr{};
+        sock_ = open_connected_udp(ip, port, 1 << 16, addr);
+
+        int prio = 6;                 // TC_PRIO_INTERACTIVE (CAP_NET_ADMIN 없이 허용되는 최대값)
+        ::setsockopt(sock_, SOL_SOCKET, SO_PRIORITY, &prio, sizeof(prio));
+        int tos = 0xB8;               // DSCP EF (Expedited Forwarding)
+        ::setsockopt(sock_, IPPROTO_IP, IP_TOS, &tos, sizeof(tos));
+    }
+
+    ~SafetyLane() {
+        if (sock_ >= 0) ::close(sock_);
+    }
+
+    // ID 조합에 대한 ESTOP/STOP 명령 미리 인코딩
+    void arm(const std::vector<uint8_t> &ids) {
         std::lock_guard<std::mutex> lk(m_);
-        q_.clear();
+        entry_locked(ids);
     }
 
-    // OK <TAG>; ... 패킷이 올 때까지 대기
-    bool wait_for_ok_tag(const std::string& expect_tag_upper,
-                        std::string& out_ok,
-                        int timeout_ms)
-    {
-        auto deadline = std::chrono::steady_clock::now() +
-                        std::chrono::milliseconds(timeout_ms > 0 ? timeout_ms : 0);
+    // 우선 송신 + ACK 대기 (estop=true: ESTOP, false: STOP)
+    bool send_wait(bool estop, const std::vector<uint8_t> &ids, int timeout_ms) {
+        const auto t_call = std::chrono::steady_clock::now();
+        const int kind = estop ? 1 : 0;
+        Waiter w;
 
         std::unique_lock<std::mutex> lk(m_);
-        auto pred = [this, &expect_tag_upper, &out_ok]() -> bool {
-            for (auto it = q_.rbegin(); it != q_.rend(); ++it) { // ★ 뒤에서부터
-                if (upper_copy(it->data).rfind("OK", 0) == 0) {
-                    std::string tag;
-                    if (extract_tag_word(it->data, tag) &&
-                        upper_copy(tag) == expect_tag_upper)
-                    {
-                        out_ok = it->data;
-                        // 최신 패킷 이후는 남기고, 찾은 것 이전만 삭제
-                        q_.erase(q_.begin(), it.base());
-                        return true;
-                    }
+        const Encoded &e = entry_locked(ids);          // map 노드 → 참조 유지
+        const std::string &cmd = estop ? e.estop : e.stop;
+
+        std::chrono::steady_clock::time_point t_sent;
+        {
+            FX_TRACE_SPAN(safety);
+            t_sent = transmit_locked(cmd);
+        }
+        waiters_[kind].push_back(&w);
+        const double send_lat = std::chrono::duration<double>(t_sent - t_call).count();
+        stats_.sent++;
+        stats_.last_send_latency = send_lat;
+        if (send_lat > stats_.max_send_latency) stats_.max_send_latency = send_lat;
+
+        const auto deadline = t_sent + std::chrono::milliseconds(timeout_ms > 0 ? timeout_ms : 0);
+        auto next_resend = t_sent + std::chrono::milliseconds(kResendMs);
+        while (!w.done) {
+            const auto now = std::chrono::steady_clock::now();
+            if (now >= deadline) break;
+            if (now >= next_resend) {
+                try {
+                    transmit_locked(cmd);
+                } catch (...) {
+                    remove_waiter_locked(kind, &w);
+                    throw;
                 }
+                stats_.resent++;
+                next_resend = now + std::chrono::milliseconds(kResendMs);
+            }
+            const auto until = std::min(deadline, next_resend);
+            if (polling_) {
+                cv_.wait_until(lk, until);
+                continue;
             }
-            return false;
-        };
 
-        if (timeout_ms <= 0) {
-            return pred(); // 논블로킹
-        }
-        while (cv_.wait_until(lk, deadline, pred) == false) {
-            if (std::chrono::steady_clock::now() >= deadline) return false;
+            // 수신 담당: 락 없이 poll/recv → 받은 ACK 를 락 아래에서 분배
+            polling_ = true;
+            lk.unlock();
+            int wait_ms = (int)std::chrono::duration_cast<std::chrono::milliseconds>(
+                              until - now).count() + 1;
+            std::vector<std::string> replies;
+            struct pollfd pfd{sock_, POLLIN, 0};
+            if (::poll(&pfd, 1, wait_ms) > 0) {
+                char buf[512];
+                ssize_t n;
+                while ((n = ::recv(sock_, buf, sizeof(buf), MSG_DONTWAIT)) > 0)
+                    replies.emplace_back(buf, (size_t)n);
+            }
+            const auto t_rx = std::chrono::steady_clock::now();
+            lk.lock();
+            polling_ = false;
+            for (const auto &reply : replies) dispatch_locked(reply, t_rx);
+            cv_.notify_all();   // ACK 전달 + 다음 수신 담당 선출
         }
-        return true;
-    }
 
-    // 아무 패킷이나 하나(가장 최근) 대기 - 태그 검증 없이
-    bool wait_for_any(std::string& out, int timeout_ms) {
-        auto deadline = std::chrono::steady_clock::now() +
-                        std::chrono::milliseconds(timeout_ms > 0 ? timeout_ms : 0);
-        std::unique_lock<std::mutex> lk(m_);
-        auto pred = [this, &out]() -> bool {
-            if (!q_.empty()) {
-                out = q_.back().data;
-                q_.clear();
-                return true;
-            }
+        if (!w.done) {
+            remove_waiter_locked(kind, &w);
+            FXCLI_LOG("[SAFETY] " << (estop ? "ESTOP" : "STOP") << " FAIL: no ACK");
             return false;
-        };
-        if (timeout_ms <= 0) return pred();
-        while (cv_.wait_until(lk, deadline, pred) == false) {
-            if (std::chrono::steady_clock::now() >= deadline) return false;
         }
+        stats_.acked++;
+        stats_.last_ack_rtt = std::chrono::duration<double>(w.t_ack - t_sent).count();
+        FXCLI_LOG("[SAFETY] " << (estop ? "ESTOP" : "STOP") << " OK");
         return true;
     }
 
+    FxSafetyStats stats() const {
+        std::lock_guard<std::mutex> lk(m_);
+        return stats_;
+    }
+
 private:
-    int sock_{-1};
-    struct sockaddr_in addr_{};
+    struct Encoded { std::string estop, stop; };
+    struct Waiter {
+        bool done = false;
+        std::chrono::steady_clock::time_point t_ack;
+    };
 
-    std::atomic<bool> run_rx_{false};
-    std::thread rx_thread_;
-    std::mutex m_;
+    // ACK 미수신 시 재송신 주기(ms)
+    static constexpr int kResendMs = 20;
+
+    int sock_{-1};
+    mutable std::mutex m_;                    // cache_/stats_/waiters_/polling_ 보호 (ACK 대기 중에는 해제)
     std::condition_variable cv_;
-    std::deque<RxPacket> q_;
-    size_t max_queue_;
+    std::map<std::vector<uint8_t>, Encoded> cache_;
+    std::deque<Waiter *> waiters_[2];         // [0]=STOP, [1]=ESTOP 대기자 (송신 순)
+    bool polling_ = false;                    // poll()/recv() 담당 스레드 존재 여부
+    FxSafetyStats stats_;
+
+    const Encoded &entry_locked(const std::vector<uint8_t> &ids) {
+        auto it = cache_.find(ids);
+        if (it != cache_.end()) return it->second;
+        const std::string group = build_id_group(ids);
+        return cache_.emplace(ids, Encoded{"AT+ESTOP " + group, "AT+STOP " + group}).first->second;
+    }
 
-    static void close_socket(int s) { ::close(s); }
+    std::chrono::steady_clock::time_point transmit_locked(const std::string &cmd) {
+        ssize_t n = ::send(sock_, cmd.data(), cmd.size(), 0);
+        if (n < 0 || (size_t)n != cmd.size()) throw std::runtime_error("send() failed");
+        return std::chrono::steady_clock::now();
+    }
 
-    void rx_loop_blocking() {
-        // 블로킹 recv 루프
-        while (run_rx_.load()) {
-            char buf[1024];
-            ssize_t n = ::recv(sock_, buf, sizeof(buf) - 1, 0);
-            if (n <= 0) {
-                // 소켓 종료/에러 시 잠깐 쉼
-                std::this_thread::sleep_for(std::chrono::milliseconds(1));
-                continue;
-            }
-            buf[n] = '\0';
+    void remove_waiter_locked(int kind, Waiter *w) {
+        auto &dq = waiters_[kind];
+        dq.erase(std::remove(dq.begin(), dq.end(), w), dq.end());
+    }
 
-            RxPacket pkt;
-            pkt.data = std::string(buf, (size_t)n);
-            pkt.t_arrival = std::chrono::steady_clock::now();
-
-            {
-                std::lock_guard<std::mutex> lk(m_);
-                if (q_.size() >= max_queue_) {
-                    // 오래된 것부터 드랍
-                    q_.pop_front();
-                }
-                q_.push_back(std::move(pkt));
-            }
-            cv_.notify_all();
-        }
+    // 대기자 없는 ACK(타임아웃된 요청의 늦은 ACK, 재송신분 중복 ACK)는 폐기
+    void dispatch_locked(const std::string &reply, std::chrono::steady_clock::time_point t_rx) {
+        std::string got;
+        if (!fx_proto::ok_tag_upper(reply, got)) return;
+        const int kind = got == "ESTOP" ? 1 : got == "STOP" ? 0 : -1;
+        if (kind < 0 || waiters_[kind].empty()) return;
+        Waiter *w = waiters_[kind].front();
+        waiters_[kind].pop_front();
+        w->done = true;
+        w->t_ack = t_rx;
     }
 };
 
 // ========= FxCli =========
+namespace {
+inline double to_sec(std::chrono::steady_clock::time_point tp) {
+    return std::chrono::duration<double>(tp.time_since_epoch()).count();
+}
+} // namespace
+
 FxCli::FxCli(const std::string &ip, uint16_t port)
-: socket_(new UdpSocket(ip, port)) {}
+: FxCli(std::make_shared<UdpTransport>(ip, port))
+{
+    safety_ = new SafetyLane(ip, port);
+}
+
+FxCli::FxCli(std::shared_ptr<FxTransport> transport)
+: FxCli(std::move(transport), 256) {}
+
+// 채널별 UdpTransport(별도 로컬 포트) → 응답도 채널별 RX 스레드/backlog 로만 들어옴
+FxCli::FxCli(const std::string &ip, uint16_t port, const FxChannelConfig &ch)
+: FxCli(std::make_shared<UdpTransport>(ip, ch.realtime.port ? ch.realtime.port : port, ch.realtime),
+        ch.realtime.max_queue)
+{
+    const uint16_t mport = ch.management.port ? ch.management.port : port;
+    mgmt_ = new UdpSocket(std::make_shared<UdpTransport>(ip, mport, ch.management),
+                          ch.management.max_queue);
+    safety_ = new SafetyLane(ip, mport);
+}
+
+FxCli::FxCli(std::shared_ptr<FxTransport> transport, size_t max_queue)
+: socket_(new UdpSocket(std::move(transport), max_queue)),
+  mgmt_(socket_),
+  safety_(nullptr),
+  clock_(new FxClockSync()),
+  mit_(new FxMitDelta()),
+  traj_(new FxTrajectoryStreamer(
+      [this](const std::vector<uint8_t> &ids,
+             const std::vector<float> &pos, const std::vector<float> &vel,
+             const std::vector<float> &kp,  const std::vector<float> &kd,
+             const std::vector<float> &tau) {
+          this->operation_control(ids, pos, vel, kp, kd, tau);
+      })) {}
 
 FxCli::~FxCli() {
 #ifdef DEBUG
     g_timer_ack.printStatistics();
 #endif
+    delete traj_;      // 스트리머 스레드가 socket_ 을 쓰므로 먼저 정지
+    if (mgmt_ != socket_) delete mgmt_;
     delete socket_;
+    delete safety_;
+    delete clock_;
+    delete mit_;
 }
 
 // ---- 내부 I/O ----
@@ -292,60 +441,123 @@ bool FxCli::send_cmd_wait_ok_tag(const std::string& cmd,
 #ifdef DEBUG
     g_timer_ack.startTimer();
 #endif
-    // 0) 직전 남은 큐 드레인
-    socket_->flush_queue();
+    FX_TRACE_SPAN(command);
 
-    // 1) 송신
-    send_cmd(cmd);
+    // 1) 응답 대기 등록 + 송신 (다른 스레드의 응답/큐는 건드리지 않음)
+    UdpSocket::Ticket ticket;
+    {
+        FX_TRACE_SPAN(send);
+        ticket = mgmt_->send_expect(upper_copy(expect_tag), cmd);
+    }
+    FXCLI_LOG("[SEND] " << cmd);
 
     // 2) 기대 TAG 대기
-    std::string out;
-    bool ok = socket_->wait_for_ok_tag(upper_copy(expect_tag), out, timeout_ms);
+    UdpSocket::RxPacket out;
+    bool ok;
+    {
+        FX_TRACE_SPAN(wait);
+        ok = mgmt_->wait_for_ok_tag(ticket, out, timeout_ms);
+    }
 
 #ifdef DEBUG
     g_timer_ack.stopTimer();
-    if (ok) std::cout << "[DEBUG] " << expect_tag << " OK: " << out << std::endl;
+    if (ok) std::cout << "[DEBUG] " << expect_tag << " OK: " << out.data << std::endl;
     else    std::cerr << "[DEBUG] " << expect_tag << " FAIL: Timeout waiting correct tag" << std::endl;
 #endif
     return ok;
 }
 
+// 송신 → TAG 대기 → 왕복 타이밍/시계 동기 갱신
+std::string FxCli::transact(UdpSocket* ch,
+                            const std::string& cmd,
+                            const char* expect_tag_upper,
+                            int timeout_ms,
+                            FxTiming* timing)
+{
+    FX_TRACE_SPAN(transact);
+
+    const double t_send = host_time();
+    UdpSocket::Ticket ticket;
+    {
+        FX_TRACE_SPAN(send);
+        ticket = ch->send_expect(expect_tag_upper, cmd);
+    }
+    FXCLI_LOG("[SEND] " << cmd);
+
+    UdpSocket::RxPacket out;
+    bool ok;
+    {
+        FX_TRACE_SPAN(wait);
+        ok = ch->wait_for_ok_tag(ticket, out, timeout_ms);   // ★ 태그 검증 - ON
+    }
+    if (!ok) {
+        clock_->observe_timeout(t_send);
+        if (timing) *timing = FxTiming{};
+        return std::string();
+    }
+
+    FX_TRACE_SPAN(clock_sync);
+    int64_t ticks = 0;
+    const bool has_mcu = fx_proto::find_uptime_ticks(out.data, ticks);
+    FxTiming t = clock_->observe(t_send, to_sec(out.t_arrival), has_mcu, ticks);
+    if (timing) *timing = t;
+    return std::move(out.data);
+}
+
 // ---- 공개 API ----
 std::string FxCli::mcu_ping() {
-    std::string cmd = "AT+PING";
-    std::string out;
-    send_cmd(cmd);
-    bool ok = socket_->wait_for_ok_tag("PING", out, timeout_ms_);   // ★ 태그 검증 - ON
-    
-    return ok ? out : std::string();
+    return transact(mgmt_, "AT+PING", "PING", timeout_ms_);
 }
 
 std::string FxCli::mcu_whoami() {
-    std::string cmd = "AT+WHOAMI";
-    std::string out;
-    send_cmd(cmd);
-    bool ok = socket_->wait_for_ok_tag("WHOAMI", out, timeout_ms_);   // ★ 태그 검증 - ON
-    
-    return ok ? out : std::string();
+    return transact(mgmt_, "AT+WHOAMI", "WHOAMI", timeout_ms_);
 }
 
+// START/STOP/ESTOP/SETZERO 는 MCU 쪽 setpoint 를 바꾸므로
+// 송신 전부터 ACK 대기 후까지 해당 모터의 MIT tick 을 전체 필드로 송신 (delta 기준 폐기)
+//  - 스트리머/제어 스레드의 tick 이 명령과 겹쳐도 MCU 처리 순서와 무관하게 setpoint 복원
+namespace {
+struct MitFullScope {
+    MitFullScope(FxMitDelta *d, const std::vector<uint8_t> &ids) : d_(d), ids_(ids) { d_->hold_full(ids_); }
+    ~MitFullScope() { d_->release_full(ids_); }
+    FxMitDelta *d_;
+    const std::vector<uint8_t> &ids_;
+};
+} // namespace
+
 bool FxCli::motor_start(const std::vector<uint8_t> &ids) {
     std::string cmd = "AT+START " + build_id_group(ids);
+    MitFullScope full(mit_, ids);
     return send_cmd_wait_ok_tag(cmd, "START", timeout_ms_);
 }
 
+// STOP/ESTOP: 우선 송신 경로(예약 소켓) 사용
+//  - 예약 소켓이 없는 전송 계층(시뮬레이터 등)은 일반 경로로 송신
 bool FxCli::motor_stop(const std::vector<uint8_t> &ids) {
-    std::string cmd = "AT+STOP " + build_id_group(ids);
-    return send_cmd_wait_ok_tag(cmd, "STOP", timeout_ms_);
+    MitFullScope full(mit_, ids);
+    return safety_
+        ? safety_->send_wait(false, ids, timeout_ms_)
+        : send_cmd_wait_ok_tag("AT+STOP " + build_id_group(ids), "STOP", timeout_ms_);
 }
 
 bool FxCli::motor_estop(const std::vector<uint8_t> &ids) {
-    std::string cmd = "AT+ESTOP " + build_id_group(ids);
-    return send_cmd_wait_ok_tag(cmd, "ESTOP", timeout_ms_);
+    MitFullScope full(mit_, ids);
+    return safety_
+        ? safety_->send_wait(true, ids, timeout_ms_)
+        : send_cmd_wait_ok_tag("AT+ESTOP " + build_id_group(ids), "ESTOP", timeout_ms_);
+}
+
+void FxCli::safety_arm(const std::vector<uint8_t> &ids) {
+    if (safety_) safety_->arm(ids);
+}
+
+FxSafetyStats FxCli::safety_stats() const {
+    return safety_ ? safety_->stats() : FxSafetyStats{};
 }
 
 bool FxCli::motor_setzero(const std::vector<uint8_t> &ids) {
     std::string cmd = "AT+SETZERO " + build_id_group(ids);
+    MitFullScope full(mit_, ids);
     return send_cmd_wait_ok_tag(cmd, "SETZERO", timeout_ms_);
 }
 
@@ -359,36 +571,79 @@ void FxCli::operation_control(const std::vector<uint8_t> &ids,
     if (!(pos.size() == n && vel.size() == n && kp.size() == n && kd.size() == n && tau.size() == n))
         throw std::invalid_argument("All parameter arrays must have the same length");
 
-    std::ostringstream oss;
-    oss << "AT+MIT ";
-    for (size_t i = 0; i < n; ++i) {
-        oss << '<' << static_cast<unsigned>(ids[i]) << ' '
-            << format_float(pos[i]) << ' ' << format_float(vel[i]) << ' '
-            << format_float(kp[i])  << ' ' << format_float(kd[i])  << ' '
-            << format_float(tau[i]) << '>';
-        if (i + 1 < n) oss << ' ';
+    FX_TRACE_SPAN(mit);
+    if (mit_->enabled()) {
+        // delta: 인코딩 + 송신을 인코더 락 아래에서 (송신 순서 == 마지막 송신값 순서)
+        mit_->send(ids, pos, vel, kp, kd, tau, [this](const std::string &cmd) {
+            FX_TRACE_SPAN(send);
+            send_cmd(cmd);
+        });
+        return;
+    }
+
+    std::string cmd;
+    {
+        FX_TRACE_SPAN(encode);
+        cmd = fx_proto::encode_mit(ids, pos, vel, kp, kd, tau);
     }
-    send_cmd(oss.str());
+    FX_TRACE_SPAN(send);
+    send_cmd(cmd);
+}
+
+void FxCli::mit_delta(bool enable, int refresh_every) {
+    mit_->configure(enable, refresh_every);
+}
+
+// ---- 궤적 스트리밍 ----
+void FxCli::traj_start(const std::vector<uint8_t> &ids, double rate_hz,
+                       FxInterp interp, int rt_priority) {
+    traj_->start(ids, rate_hz, interp, rt_priority);
+}
+
+void FxCli::traj_stop() {
+    traj_->stop();
+}
+
+void FxCli::traj_load(const std::vector<FxWaypoint> &wps, bool append) {
+    traj_->load(wps, append);
+}
+
+bool FxCli::traj_running() const {
+    return traj_->running();
+}
+
+double FxCli::traj_time() const {
+    return traj_->time();
+}
+
+FxTrajStats FxCli::traj_stats() const {
+    return traj_->stats();
 }
 
 // ---- 데이터 요청 ----
 std::string FxCli::req(const std::vector<uint8_t> &ids)
 {
-    std::string cmd = "AT+REQ " + build_id_group(ids);
+    return req(ids, nullptr);
+}
+
+std::string FxCli::req(const std::vector<uint8_t> &ids, FxTiming *timing)
+{
+    std::string cmd;
+    {
+        FX_TRACE_SPAN(encode);
+        cmd = "AT+REQ " + build_id_group(ids);
+    }
 
 #ifdef DEBUG
     g_timer_ack.startTimer();
 #endif
-    send_cmd(cmd);
-
-    std::string out;
-    bool ok = socket_->wait_for_ok_tag("REQ", out, timeout_ms_rt_);   // ★ 태그 검증 - ON
+    std::string out = transact(socket_, cmd, "REQ", timeout_ms_rt_, timing);
     // bool ok = socket_->wait_for_any(out, timeout_ms_);   // ★ 태그 검증 - OFF
-    
+
 #ifdef DEBUG
     g_timer_ack.stopTimer();
 #endif
-    return ok ? out : std::string();
+    return out;
 }
 
 std::string FxCli::status()
@@ -398,20 +653,42 @@ std::string FxCli::status()
 #ifdef DEBUG
     g_timer_ack.startTimer();
 #endif
-    socket_->flush_queue();
-    send_cmd(cmd);
-
-    std::string out;
-    bool ok = socket_->wait_for_ok_tag("STATUS", out, timeout_ms_rt_);   // ★ 태그 검증 - ON
+    std::string out = transact(mgmt_, cmd, "STATUS", timeout_ms_rt_);
     // bool ok = socket_->wait_for_any(out, timeout_ms_);   // ★ 태그 검증 없음
 #ifdef DEBUG
     g_timer_ack.stopTimer();
 #endif
-    return ok ? out : std::string();
+    return out;
+}
+
+FxReply FxCli::req_reply(const std::vector<uint8_t>& ids, FxTiming* timing) {
+    return FxReply::parse(req(ids, timing));
+}
+
+FxReply FxCli::status_reply() {
+    return FxReply::parse(status());
 }
 
 void FxCli::flush() {
     if (!socket_) return;
     socket_->flush_queue();
+    if (mgmt_ != socket_) mgmt_->flush_queue();
     FXCLI_LOG("[FLUSH] queue cleared");
-}
\ No newline at end of file
+}
+
+// ---- 시계 동기 ----
+FxTiming FxCli::last_timing() const {
+    return clock_->last();
+}
+
+FxClockSyncState FxCli::clock_sync() const {
+    return clock_->state();
+}
+
+void FxCli::clock_sync_reset() {
+    clock_->reset();
+}
+
+double FxCli::host_time() {
+    return to_sec(std::chrono::steady_clock::now());
+}
@@ -2,14 +2,92 @@
 
 #include <string>
 #include <vector>
+#include <memory>
 #include <cstdint>
 
+#include "fx_reply.h"
+#include "fx_trajectory.h"
+#include "fx_transport.h"
+
+// 응답 1건의 타이밍 (시각은 host steady_clock 기준 초, Python time.monotonic() 과 동일 기준)
+struct FxTiming {
+  bool   valid = false;      // 응답 수신 여부
+  bool   synced = false;     // 응답의 uptime + 시계 동기 추정으로 t_sample 을 산출했는지 여부
+  bool   estimated = false;  // uptime 없는 응답(REQ 등): 동기 상태의 min_rtt 로 t_sample 추정
+  double t_send = 0.0;       // 명령 송신 시각
+  double t_arrival = 0.0;    // 응답 도착 시각 (RX 스레드 수신 시각)
+  double rtt = 0.0;          // 왕복 시간
+  double mcu_time = -1.0;    // 응답의 MCU uptime [s] (없으면 -1)
+  double t_sample = 0.0;     // MCU 샘플 시각의 host clock 환산 (미동기 시 왕복 중간값)
+  double latency = 0.0;      // 단방향 지연 추정 = t_arrival - t_sample
+};
+
+// Host ↔ MCU 시계 동기 추정 상태
+struct FxClockSyncState {
+  bool   synced = false;
+  size_t samples = 0;        // 윈도우 내 MCU 타임스탬프 샘플 수
+  double offset = 0.0;       // (MCU uptime - host) [s], 최근 샘플 시점 기준
+  double drift_ppm = 0.0;    // MCU 시계 drift (host 대비)
+  double min_rtt = 0.0;      // 윈도우 최소 RTT [s]
+  double last_rtt = 0.0;     // 마지막 왕복 RTT [s]
+};
+
+// 안전 명령(ESTOP/STOP) 우선 송신 경로 통계
+struct FxSafetyStats {
+  uint64_t sent = 0;               // 송신 명령 수 (재송신 제외)
+  uint64_t resent = 0;             // ACK 미수신으로 인한 재송신 수
+  uint64_t acked = 0;              // ACK 수신 수
+  double   last_send_latency = 0.0; // 호출 → send() 완료 [s]
+  double   max_send_latency = 0.0;
+  double   last_ack_rtt = 0.0;      // send() → ACK 수신 [s]
+};
+
+// discover() 로 찾은 MCU 엔드포인트
+struct FxEndpoint {
+  std::string ip;            // 응답 송신지 (브로드캐스트로 찾은 경우 보드의 실제 주소)
+  uint16_t    port = 0;
+  double      rtt = 0.0;     // 송신 → 첫 응답 [s]
+  bool        ping = false;  // <PING> 응답 수신 여부
+  FxReply     whoami;        // <WHOAMI> 응답 (미수신 시 empty())
+};
+
+// 채널별 소켓/수신 설정 (FxCli(ip, port, FxChannelConfig))
+struct FxChannelOptions {
+  uint16_t port = 0;           // MCU 포트 (0: 생성자 port)
+  int      rcvbuf = 1 << 20;   // SO_RCVBUF [bytes]
+  size_t   max_queue = 256;    // 대기자 없던 패킷 backlog 상한 (초과 시 오래된 것부터 drop)
+  int      rx_priority = 0;    // RX 스레드 SCHED_FIFO 우선순위 (0: 일반, 권한 없으면 무시)
+  int      so_priority = 0;    // SO_PRIORITY (0: 미설정, 1~6 은 권한 없이 허용)
+};
+
+// 제어/관리 트래픽 분리
+//  - realtime  : MIT, REQ
+//  - management: PING, WHOAMI, START, SETZERO, STATUS, STOP/ESTOP 예약 소켓
+//  - 채널마다 별도 소켓(로컬 포트) + RX 스레드 + 응답 backlog → STATUS 버스트가 REQ 응답을 밀어내지 않음
+struct FxChannelConfig {
+  FxChannelOptions realtime;
+  FxChannelOptions management{0, 1 << 16, 64, 0, 0};
+};
+
+class FxClockSync;
+class FxMitDelta;
+
 // 리눅스 전용 UDP 클라이언트
 // - 내부적으로 RX 전용 스레드와 링버퍼를 운영하여
 //   측정 지연 편차를 최소화하고 안정적인 패킷 수신을 지원.
+// - 공개 API 는 스레드 안전: 요청마다 in-flight 티켓을 등록하고
+//   RX 스레드가 "OK <TAG>" 응답을 TAG 별 FIFO 로 해당 티켓에만 전달.
 class FxCli {
 public:
   FxCli(const std::string& ip, uint16_t port);
+
+  // 임의 전송 계층 사용 (예: FxSimMcu 인프로세스 시뮬레이터)
+  //  - STOP/ESTOP 예약 소켓 없음 → 일반 경로로 송신
+  explicit FxCli(std::shared_ptr<FxTransport> transport);
+
+  // 제어/관리 채널 분리 (MCU 는 요청 송신 포트로 응답한다고 가정)
+  FxCli(const std::string& ip, uint16_t port, const FxChannelConfig& channels);
+
   FxCli(const FxCli&) = delete;
   FxCli& operator=(const FxCli&) = delete;
   ~FxCli();
@@ -26,6 +104,11 @@ public:
   bool motor_estop(const std::vector<uint8_t>& ids);
   bool motor_setzero(const std::vector<uint8_t> &ids);
 
+  // STOP/ESTOP 은 전용 예약 소켓으로 우선 송신 (일반 I/O 락/큐와 무관)
+  //  - safety_arm: ID 조합별 명령을 미리 인코딩 (첫 호출 비용 제거)
+  void safety_arm(const std::vector<uint8_t>& ids);
+  FxSafetyStats safety_stats() const;
+
   // MIT 제어 
   void operation_control(const std::vector<uint8_t>& ids,
                          const std::vector<float>& pos,
@@ -34,6 +117,24 @@ public:
                          const std::vector<float>& kd,
                          const std::vector<float>& tau);
 
+  // MIT delta 인코딩 (MCU 가 AT+MITD 를 지원해야 함, 기본 off)
+  //  - 모터별 마지막 송신값과 다른 필드만 송신 (kp/kd 등 고정 필드 생략 → 패킷/인코딩 축소)
+  //  - refresh_every tick 마다 모터별 전체 필드 재송신 (유실 대비, <= 0 이면 안 함)
+  //  - START/STOP/ESTOP/SETZERO 진행 중 + 완료 후 첫 tick 은 해당 모터 전체 송신
+  void mit_delta(bool enable, int refresh_every = 50);
+
+  // 궤적 스트리밍 (C++ 타이머 스레드가 보간 후 rate_hz 로 AT+MIT 송신)
+  //  - traj_start: 대상 ids/주기/보간 방식 설정 후 스레드 시작 (궤적 없으면 송신 안 함)
+  //  - traj_load : 궤적 교체(append=false, t 는 교체 시점 기준) 또는 추가(append=true)
+  //  - 스트리밍 중 같은 ids 에 operation_control 직접 호출 금지
+  void traj_start(const std::vector<uint8_t>& ids, double rate_hz = 1000.0,
+                  FxInterp interp = FxInterp::CubicHermite, int rt_priority = 0);
+  void traj_stop();
+  void traj_load(const std::vector<FxWaypoint>& wps, bool append = false);
+  bool traj_running() const;
+  double traj_time() const;
+  FxTrajStats traj_stats() const;
+
   // 데이터 질의
   //  - req   : <REQ> 태그가 올 때까지 큐에서 대기 후 가장 최근 패킷 반환
   //  - status: <STATUS> 태그가 올 때까지 대기 후 패킷 반환
@@ -41,9 +142,41 @@ public:
   std::string req   (const std::vector<uint8_t>& ids);
   std::string status();
 
-  // 큐에 남아있는 모든 수신 패킷을 즉시 폐기
+  //  - req + 해당 응답의 타이밍 (멀티스레드에서 last_timing() 대신 사용)
+  std::string req   (const std::vector<uint8_t>& ids, FxTiming* timing);
+
+  //  - 구조화 응답 (FxReply 로 파싱, 응답 없으면 empty())
+  //    ex) double p; r.get_double("M1", "p", p);
+  FxReply req_reply   (const std::vector<uint8_t>& ids, FxTiming* timing = nullptr);
+  FxReply status_reply();
+
+  // 대기자 없이 수신된(미매칭) 패킷을 즉시 폐기 (채널 분리 시 양쪽 모두)
+  //  - 진행 중인 다른 요청의 응답에는 영향 없음
   void flush();
 
+  // ──────────────────────────
+  // 시계 동기 / 지연 보상
+  // ──────────────────────────
+  //  - PING/WHOAMI/REQ/STATUS 왕복마다 응답의 "uptime:" 으로 offset/drift 추정
+  //  - last_timing: 직전 왕복(응답)의 샘플 시각/지연 추정 (모든 스레드 중 가장 최근)
+  FxTiming last_timing() const;
+  FxClockSyncState clock_sync() const;
+  void clock_sync_reset();
+
+  // host steady_clock 현재 시각 [s] (FxTiming 과 동일 기준)
+  static double host_time();
+
+  // ──────────────────────────
+  // MCU 탐색
+  // ──────────────────────────
+  //  - addrs 각각("ip" 또는 "ip:port", 서브넷 브로드캐스트 주소 허용)에 AT+PING/AT+WHOAMI 를
+  //    소켓 1개로 한꺼번에 송신 → timeout_ms 동안 들어온 응답을 송신지별로 수집
+  //  - 모든 유니캐스트 대상이 PING/WHOAMI 모두 응답하면 즉시 반환 (브로드캐스트 포함 시 창 끝까지 대기)
+  //  - 반환 순서: 첫 응답 도착 순 (≈ RTT 순)
+  //  - 잘못된 주소 문자열은 std::invalid_argument
+  static std::vector<FxEndpoint> discover(const std::vector<std::string>& addrs,
+                                          uint16_t port, int timeout_ms = 200);
+
 private:
   // ──────────────────────────
   // 내부 I/O 유틸
@@ -56,13 +189,38 @@ private:
                          const char* expect_tag,
                          int timeout_ms);
 
+  class UdpSocket;
+
+  // 공통 초기화 (transport → realtime 채널, mgmt_ 는 같은 채널로 시작)
+  FxCli(std::shared_ptr<FxTransport> transport, size_t max_queue);
+
+  // 송신 후 TAG 응답 대기 + 왕복 타이밍 기록 (응답 없으면 빈 문자열)
+  std::string transact(UdpSocket* ch,
+                       const std::string& cmd,
+                       const char* expect_tag_upper,
+                       int timeout_ms,
+                       FxTiming* timing = nullptr);
+
   // 기본 대기시간(ms)
   int timeout_ms_ = 200;
   int timeout_ms_rt_ = 5;
 
   // ──────────────────────────
-  // 내부 UDP 소켓 + 수신 스레드/큐 관리
+  // 송신 직렬화 + 응답 분배 (하부 FxTransport 소유)
   // ──────────────────────────
-  class UdpSocket;
-  UdpSocket* socket_;
+  UdpSocket* socket_;   // realtime 채널 (MIT/REQ)
+  UdpSocket* mgmt_;     // management 채널 (채널 미분리 시 socket_ 과 동일)
+
+  // 안전 명령 우선 송신 경로 (예약 소켓, UDP 전송에서만 사용)
+  class SafetyLane;
+  SafetyLane* safety_;
+
+  // Host ↔ MCU 시계 동기 추정기
+  FxClockSync* clock_;
+
+  // MIT delta 인코더 (마지막 송신값)
+  FxMitDelta* mit_;
+
+  // 궤적 스트리머 (operation_control 로 송신)
+  FxTrajectoryStreamer* traj_;
 };
\ No newline at end of file
@@ -0,0 +1,151 @@
+#include "fx_clock_sync.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+// 동기 판정에 필요한 최소 MCU 타임스탬프 샘플 수
+constexpr size_t kMinSamples = 3;
+// drift 추정에 필요한 최소 host 시간 폭 [s] (그 전에는 drift=0)
+constexpr double kMinDriftSpan = 10.0;
+// 허용 drift 한계 (수정발진기 기준 여유 있게)
+constexpr double kMaxDrift = 500e-6;
+// uptime 이 예측보다 이만큼 [s] 뒤로 가면 MCU 재부팅으로 간주
+constexpr double kResetJump = 1.0;
+
+} // namespace
+
+FxClockSync::FxClockSync(size_t window, double mcu_tick_s)
+: window_(window < kMinSamples ? kMinSamples : window),
+  tick_s_(mcu_tick_s) {}
+
+FxTiming FxClockSync::observe(double t_send_s, double t_arrival_s,
+                              bool has_mcu, int64_t mcu_ticks)
+{
+    std::lock_guard<std::mutex> lk(m_);
+
+    FxTiming t;
+    t.valid     = true;
+    t.t_send    = t_send_s;
+    t.t_arrival = t_arrival_s;
+    t.rtt       = t_arrival_s - t_send_s;
+    last_rtt_   = t.rtt;
+
+    const double mid = 0.5 * (t_send_s + t_arrival_s);
+    double mcu_s = 0.0;
+
+    if (has_mcu) {
+        // uptime 은 tick 단위 내림값 → 구간 중앙(+0.5 tick)으로 보정
+        mcu_s = (static_cast<double>(mcu_ticks) + 0.5) * tick_s_;
+        t.mcu_time = mcu_s;
+
+        if (!win_.empty() && mcu_s < win_.back().mcu - kResetJump) {
+            win_.clear();           // MCU 재부팅
+            synced_ = false;
+            anchored_ = false;
+            drift_ = 0.0;
+        }
+        win_.push_back({mid, t.rtt, mcu_s});
+        while (win_.size() > window_) win_.pop_front();
+        refit_locked();
+    }
+
+    if (has_mcu && synced_) {
+        // MCU 샘플은 반드시 [송신, 도착] 사이에서 일어남 → 범위로 제한
+        double h = ref_ + (mcu_s - a_) / b_;
+        t.synced   = true;
+        t.t_sample = std::min(std::max(h, t_send_s), t_arrival_s);
+    } else if (synced_) {
+        // uptime 없는 응답: MCU 는 응답 직전에 샘플 → 도착에서 무부하 단방향 지연만큼 역산
+        //  (요청 방향 큐잉/처리 지연은 샘플 이전으로 귀속, [송신, 도착] 범위로 제한)
+        t.estimated = true;
+        t.t_sample  = std::min(std::max(t_arrival_s - 0.5 * min_rtt_, t_send_s), t_arrival_s);
+    } else {
+        t.t_sample = mid;
+    }
+    t.latency = t_arrival_s - t.t_sample;
+
+    last_ = t;
+    return t;
+}
+
+void FxClockSync::observe_timeout(double t_send_s) {
+    std::lock_guard<std::mutex> lk(m_);
+    last_ = FxTiming{};
+    last_.t_send = t_send_s;
+}
+
+void FxClockSync::refit_locked() {
+    if (win_.size() < kMinSamples) { synced_ = false; return; }
+
+    // RTT 하위 절반 선택
+    std::vector<Sample> sel(win_.begin(), win_.end());
+    std::sort(sel.begin(), sel.end(),
+              [](const Sample &x, const Sample &y) { return x.rtt < y.rtt; });
+    min_rtt_ = sel.front().rtt;
+    sel.resize(std::max(kMinSamples, (sel.size() + 1) / 2));
+
+    double sum_h = 0.0, sum_m = 0.0;
+    for (const auto &s : sel) {
+        sum_h += s.mid;
+        sum_m += s.mcu;
+    }
+    const double n = static_cast<double>(sel.size());
+    ref_ = sum_h / n;
+    a_   = sum_m / n;      // ref_ 를 평균으로 잡으면 절편 = mcu 평균
+
+    // drift: 윈도우 내 기울기는 tick 양자화에 묻히므로 장기 offset 변화율로 추정
+    const double offset = a_ - ref_;
+    if (!anchored_) {
+        anchored_ = true;
+        anchor_h_ = ref_;
+        anchor_off_ = offset;
+    } else if (ref_ - anchor_h_ >= kMinDriftSpan) {
+        const double d = (offset - anchor_off_) / (ref_ - anchor_h_);
+        drift_ = std::min(std::max(d, -kMaxDrift), kMaxDrift);
+    }
+    b_ = 1.0 + drift_;
+    synced_ = true;
+}
+
+bool FxClockSync::mcu_to_host(int64_t mcu_ticks, double &out_host_s) const {
+    std::lock_guard<std::mutex> lk(m_);
+    if (!synced_) return false;
+    const double mcu_s = (static_cast<double>(mcu_ticks) + 0.5) * tick_s_;
+    out_host_s = ref_ + (mcu_s - a_) / b_;
+    return true;
+}
+
+FxTiming FxClockSync::last() const {
+    std::lock_guard<std::mutex> lk(m_);
+    return last_;
+}
+
+FxClockSyncState FxClockSync::state() const {
+    std::lock_guard<std::mutex> lk(m_);
+    FxClockSyncState st;
+    st.synced    = synced_;
+    st.samples   = win_.size();
+    st.min_rtt   = min_rtt_;
+    st.last_rtt  = last_rtt_;
+    st.drift_ppm = (b_ - 1.0) * 1e6;
+    if (synced_ && !win_.empty()) {
+        // 가장 최근 샘플 시점 기준 (mcu - host)
+        const double h = win_.back().mid;
+        st.offset = a_ + b_ * (h - ref_) - h;
+    }
+    return st;
+}
+
+void FxClockSync::reset() {
+    std::lock_guard<std::mutex> lk(m_);
+    win_.clear();
+    synced_ = false;
+    ref_ = a_ = 0.0;
+    b_ = 1.0;
+    anchored_ = false;
+    anchor_h_ = anchor_off_ = drift_ = 0.0;
+    min_rtt_ = last_rtt_ = 0.0;
+    last_ = FxTiming{};
+}
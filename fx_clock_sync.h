@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+
+#include "fx_client.h"
+
+// Host(steady_clock) ↔ MCU(uptime) 시계 동기 추정기 (NTP 방식, 내부용)
+// - 왕복 1회 = (t_send, t_arrival, mcu_time) 샘플
+//   * mid = (t_send + t_arrival)/2 시점에 MCU 가 mcu_time 을 찍었다고 가정 (오차 ≤ rtt/2)
+// - 최근 window 개 중 RTT 하위 절반만 사용 → 큐잉 지연이 큰 샘플 배제
+// - mcu = a + b·(host - ref): a 는 선택 샘플 평균, b = 1 + drift
+//   * drift 는 첫 동기 시점 대비 offset 변화율 (장기 기울기)
+// - MCU 재부팅(uptime 역행) 감지 시 윈도우 초기화
+class FxClockSync {
+public:
+  explicit FxClockSync(size_t window = 64, double mcu_tick_s = 1e-3);
+
+  // 왕복 1회 반영 후 해당 응답의 타이밍 산출
+  // - has_mcu=false (응답에 uptime 없음, 예: REQ): 윈도우는 갱신하지 않음
+  //   * 동기 후: 샘플 시각 = 도착 - min_rtt/2 (복귀 경로는 혼잡 없다고 가정, estimated=true)
+  //   * 동기 전: 왕복 중간값
+  FxTiming observe(double t_send_s, double t_arrival_s,
+                   bool has_mcu, int64_t mcu_ticks);
+
+  // 응답 없음(타임아웃) 기록
+  void observe_timeout(double t_send_s);
+
+  // MCU tick → host clock [s] 환산 (동기 전이면 false)
+  bool mcu_to_host(int64_t mcu_ticks, double &out_host_s) const;
+
+  FxTiming last() const;
+  FxClockSyncState state() const;
+  void reset();
+
+private:
+  struct Sample { double mid; double rtt; double mcu; };
+
+  void refit_locked();
+
+  mutable std::mutex m_;
+  std::deque<Sample> win_;
+  size_t window_;
+  double tick_s_;
+
+  // 적합 결과: mcu = a_ + b_·(host - ref_)
+  bool   synced_ = false;
+  double ref_ = 0.0;
+  double a_ = 0.0;
+  double b_ = 1.0;
+  double drift_ = 0.0;
+
+  // drift 추정 기준점 (첫 동기 시점의 host 시각 / offset)
+  bool   anchored_ = false;
+  double anchor_h_ = 0.0;
+  double anchor_off_ = 0.0;
+
+  double min_rtt_ = 0.0;
+  double last_rtt_ = 0.0;
+
+  FxTiming last_;
+};
@@ -0,0 +1,153 @@
+#include "fx_client.h"
+#include "fx_protocol.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// "ip" 또는 "ip:port" → sockaddr_in (실패 시 예외)
+struct sockaddr_in parse_target(const std::string &addr, uint16_t default_port) {
+    std::string ip = addr;
+    fx_proto::trim(ip);
+    uint16_t port = default_port;
+
+    const size_t colon = ip.rfind(':');
+    if (colon != std::string::npos) {
+        const std::string p = ip.substr(colon + 1);
+        char *end = nullptr;
+        const long v = std::strtol(p.c_str(), &end, 10);
+        if (p.empty() || *end != '\0' || v <= 0 || v > 65535)
+            throw std::invalid_argument("invalid port in address: " + addr);
+        port = static_cast<uint16_t>(v);
+        ip.resize(colon);
+    }
+
+    struct sockaddr_in sa{};
+    sa.sin_family = AF_INET;
+    sa.sin_port   = htons(port);
+    if (::inet_pton(AF_INET, ip.c_str(), &sa.sin_addr) != 1)
+        throw std::invalid_argument("invalid IPv4 address: " + addr);
+    return sa;
+}
+
+inline uint64_t endpoint_key(const struct sockaddr_in &sa) {
+    return (static_cast<uint64_t>(ntohl(sa.sin_addr.s_addr)) << 16) | ntohs(sa.sin_port);
+}
+
+// 탐색 전용 소켓 (미연결, 브로드캐스트 허용)
+struct ProbeSocket {
+    int fd = -1;
+    ProbeSocket() {
+        fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+        if (fd < 0) throw std::runtime_error("socket() failed");
+        int on = 1;
+        ::setsockopt(fd, SOL_SOCKET, SO_BROADCAST, &on, sizeof(on));
+        int rcvbuf = 1 << 20;   // 브로드캐스트 응답 버스트 대비
+        ::setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+    }
+    ~ProbeSocket() { if (fd >= 0) ::close(fd); }
+    ProbeSocket(const ProbeSocket &) = delete;
+    ProbeSocket &operator=(const ProbeSocket &) = delete;
+};
+
+} // namespace
+
+std::vector<FxEndpoint> FxCli::discover(const std::vector<std::string> &addrs,
+                                        uint16_t port, int timeout_ms) {
+    struct Target {
+        struct sockaddr_in sa;
+        Clock::time_point t_send;
+        bool sent = false;
+    };
+    std::vector<Target> targets;
+    targets.reserve(addrs.size());
+    for (const auto &a : addrs) targets.push_back(Target{parse_target(a, port), {}, false});
+
+    std::vector<FxEndpoint> found;
+    if (targets.empty()) return found;
+
+    ProbeSocket sock;
+    static const char kPing[]   = "AT+PING";
+    static const char kWhoami[] = "AT+WHOAMI";
+
+    // 1) 전 대상에 한꺼번에 송신 (전송 실패한 대상은 건너뜀: 경로 없음 등)
+    const auto t_start = Clock::now();
+    std::unordered_map<uint64_t, size_t> target_idx;
+    for (size_t i = 0; i < targets.size(); ++i) {
+        auto &t = targets[i];
+        const auto *sa = reinterpret_cast<const struct sockaddr *>(&t.sa);
+        t.t_send = Clock::now();
+        const bool ok_ping = ::sendto(sock.fd, kPing, sizeof(kPing) - 1, 0, sa, sizeof(t.sa)) >= 0;
+        const bool ok_who  = ::sendto(sock.fd, kWhoami, sizeof(kWhoami) - 1, 0, sa, sizeof(t.sa)) >= 0;
+        t.sent = ok_ping || ok_who;
+        if (t.sent) target_idx.emplace(endpoint_key(t.sa), i);
+    }
+
+    size_t pending = target_idx.size();   // PING/WHOAMI 둘 다 받지 못한 유니캐스트 대상 수
+    if (pending == 0) return found;
+
+    // 2) 하나의 대기창 안에서 송신지별 수집
+    std::unordered_map<uint64_t, size_t> found_idx;
+    const auto deadline = t_start + std::chrono::milliseconds(timeout_ms > 0 ? timeout_ms : 0);
+    char buf[1024];
+    std::string tag;
+    for (;;) {
+        const auto now = Clock::now();
+        if (now >= deadline || pending == 0) break;
+        const int wait_ms = static_cast<int>(
+            std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count()) + 1;
+
+        struct pollfd pfd{sock.fd, POLLIN, 0};
+        if (::poll(&pfd, 1, wait_ms) <= 0) continue;
+
+        struct sockaddr_in from{};
+        socklen_t from_len = sizeof(from);
+        const ssize_t n = ::recvfrom(sock.fd, buf, sizeof(buf), MSG_DONTWAIT,
+                                     reinterpret_cast<struct sockaddr *>(&from), &from_len);
+        const auto t_arrival = Clock::now();
+        if (n <= 0) continue;
+
+        std::string reply(buf, static_cast<size_t>(n));
+        if (!fx_proto::ok_tag_upper(reply, tag)) continue;
+        const bool is_ping = (tag == "PING");
+        if (!is_ping && tag != "WHOAMI") continue;
+
+        const uint64_t key = endpoint_key(from);
+        auto it = found_idx.find(key);
+        if (it == found_idx.end()) {
+            // 유니캐스트 대상이면 그 송신 시각, 브로드캐스트로 찾은 보드면 최초 송신 시각 기준
+            auto ti = target_idx.find(key);
+            const auto t_send = (ti != target_idx.end()) ? targets[ti->second].t_send : t_start;
+
+            FxEndpoint ep;
+            char ip[INET_ADDRSTRLEN] = {0};
+            ::inet_ntop(AF_INET, &from.sin_addr, ip, sizeof(ip));
+            ep.ip = ip;
+            ep.port = ntohs(from.sin_port);
+            ep.rtt = std::chrono::duration<double>(t_arrival - t_send).count();
+            it = found_idx.emplace(key, found.size()).first;
+            found.push_back(std::move(ep));
+        }
+
+        FxEndpoint &ep = found[it->second];
+        const bool was_done = ep.ping && !ep.whoami.empty();
+        if (is_ping) ep.ping = true;
+        else         ep.whoami = FxReply::parse(std::move(reply));
+        if (!was_done && ep.ping && !ep.whoami.empty() && target_idx.count(key)) --pending;
+    }
+    return found;
+}
@@ -0,0 +1,121 @@
+#include "fx_mit_delta.h"
+
+#include "fx_protocol.h"
+#include "fx_trace.h"
+
+namespace {
+
+// 필드 접두 문자 (pos, vel, kp, kd, tau)
+constexpr char kFieldTag[5] = {'p', 'v', 'k', 'd', 't'};
+
+} // namespace
+
+void FxMitDelta::configure(bool enabled, int refresh_every) {
+    std::lock_guard<std::mutex> lk(m_);
+    enabled_.store(enabled, std::memory_order_relaxed);
+    refresh_every_ = refresh_every;
+    for (auto &l : last_) {
+        const uint32_t hold = l.hold;   // 진행 중인 명령의 hold 는 유지
+        l = Last{};
+        l.hold = hold;
+    }
+}
+
+bool FxMitDelta::enabled() const {
+    return enabled_.load(std::memory_order_relaxed);
+}
+
+void FxMitDelta::send(const std::vector<uint8_t> &ids,
+                      const std::vector<float> &pos, const std::vector<float> &vel,
+                      const std::vector<float> &kp,  const std::vector<float> &kd,
+                      const std::vector<float> &tau, const SendFn &send) {
+    std::lock_guard<std::mutex> lk(m_);
+    const std::string cmd = encode_locked(ids, pos, vel, kp, kd, tau);
+    try {
+        send(cmd);
+    } catch (...) {
+        invalidate_locked(ids);
+        throw;
+    }
+}
+
+std::string FxMitDelta::encode(const std::vector<uint8_t> &ids,
+                               const std::vector<float> &pos, const std::vector<float> &vel,
+                               const std::vector<float> &kp,  const std::vector<float> &kd,
+                               const std::vector<float> &tau) {
+    std::lock_guard<std::mutex> lk(m_);
+    return encode_locked(ids, pos, vel, kp, kd, tau);
+}
+
+std::string FxMitDelta::encode_locked(const std::vector<uint8_t> &ids,
+                                      const std::vector<float> &pos, const std::vector<float> &vel,
+                                      const std::vector<float> &kp,  const std::vector<float> &kd,
+                                      const std::vector<float> &tau) {
+    FX_TRACE_SPAN(encode);
+    if (!enabled_.load(std::memory_order_relaxed))
+        return fx_proto::encode_mit(ids, pos, vel, kp, kd, tau);
+
+    std::string out = "AT+MITD";
+    for (size_t i = 0; i < ids.size(); ++i) {
+        Last &l = last_[ids[i]];
+        const float v[5] = {pos[i], vel[i], kp[i], kd[i], tau[i]};
+        const bool full = !l.valid || l.hold > 0 || hold_all_ > 0 ||
+                          (refresh_every_ > 0 && l.since_full + 1 >= (uint32_t)refresh_every_);
+
+        bool opened = false;
+        for (int f = 0; f < 5; ++f) {
+            if (!full && v[f] == l.v[f]) continue;
+            if (!opened) {
+                out += " <";
+                out += std::to_string(static_cast<unsigned>(ids[i]));
+                opened = true;
+            }
+            out += ' ';
+            out += kFieldTag[f];
+            out += fx_proto::format_float(v[f]);
+            l.v[f] = v[f];
+        }
+        if (opened) out += '>';
+
+        l.valid = true;
+        l.since_full = full ? 0 : l.since_full + 1;
+    }
+    return out;
+}
+
+void FxMitDelta::invalidate(const std::vector<uint8_t> &ids) {
+    std::lock_guard<std::mutex> lk(m_);
+    invalidate_locked(ids);
+}
+
+void FxMitDelta::hold_full(const std::vector<uint8_t> &ids) {
+    std::lock_guard<std::mutex> lk(m_);
+    for (uint8_t id : ids) {
+        if (id == 0xFF) { ++hold_all_; return; }
+    }
+    for (uint8_t id : ids) ++last_[id].hold;
+}
+
+// hold 해제 + 마지막 송신값 폐기 → 명령 완료 후 첫 tick 도 전체 송신
+void FxMitDelta::release_full(const std::vector<uint8_t> &ids) {
+    std::lock_guard<std::mutex> lk(m_);
+    bool all = false;
+    for (uint8_t id : ids) all = all || id == 0xFF;
+    if (all) {
+        if (hold_all_ > 0) --hold_all_;
+    } else {
+        for (uint8_t id : ids)
+            if (last_[id].hold > 0) --last_[id].hold;
+    }
+    invalidate_locked(ids);
+}
+
+void FxMitDelta::invalidate_locked(const std::vector<uint8_t> &ids) {
+    for (uint8_t id : ids) {
+        if (id == 0xFF) {
+            for (auto &l : last_) l.valid = false;
+            return;
+        }
+        last_[id].valid = false;
+    }
+}
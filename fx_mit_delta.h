@@ -0,0 +1,69 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// MIT 명령 delta 인코더 (sticky 값, 내부용)
+// - 모터별 마지막 송신값을 기억하고 바뀐 필드만 AT+MITD 로 송신
+//     AT+MITD <id p<pos> v<vel> k<kp> d<kd> t<tau>> ...
+//     ex) "AT+MITD <1 p0.51> <2 p-0.2 t0.1>"
+//   * 그룹 안 필드 순서/개수 자유, 생략된 필드는 MCU 가 직전 값 유지
+//   * 바뀐 필드가 없는 모터는 그룹 생략, 전부 없으면 "AT+MITD" 만 송신 (keepalive)
+// - 패킷 유실 대비: 모터별 refresh_every tick 마다 5개 필드 전부 송신
+//   (처음 보내는 모터, invalidate() 된 모터도 전체 송신)
+// - 비활성 시 기존 AT+MIT 전체 인코딩
+class FxMitDelta {
+public:
+  using SendFn = std::function<void(const std::string&)>;
+
+  // refresh_every <= 0: 주기적 전체 송신 없음
+  void configure(bool enabled, int refresh_every);
+  bool enabled() const;
+
+  // 인코딩 + 송신을 하나의 락 아래에서 수행 (송신 순서 == 인코더 상태 순서)
+  //  - send 가 예외를 던지면 해당 모터들은 다음 tick 에 전체 송신
+  void send(const std::vector<uint8_t>& ids,
+            const std::vector<float>& pos, const std::vector<float>& vel,
+            const std::vector<float>& kp,  const std::vector<float>& kd,
+            const std::vector<float>& tau, const SendFn& send);
+
+  // 인코딩만 (상태 갱신 포함)
+  std::string encode(const std::vector<uint8_t>& ids,
+                     const std::vector<float>& pos, const std::vector<float>& vel,
+                     const std::vector<float>& kp,  const std::vector<float>& kd,
+                     const std::vector<float>& tau);
+
+  // 마지막 송신값 폐기 → 다음 tick 전체 송신 (0xFF 포함 시 전체 모터)
+  void invalidate(const std::vector<uint8_t>& ids);
+
+  // 명령 진행 구간 동안 해당 모터는 매 tick 전체 송신 (0xFF 포함 시 전체 모터)
+  //  - START/STOP/ESTOP/SETZERO 송신 전 hold_full, ACK 대기 후 release_full (중첩 가능)
+  //  - 명령과 겹쳐 MCU 처리 전/후 어느 쪽에 도착한 tick 이든 delta 기준이 어긋나지 않음
+  void hold_full(const std::vector<uint8_t>& ids);
+  void release_full(const std::vector<uint8_t>& ids);
+
+private:
+  struct Last {
+    float    v[5] = {0, 0, 0, 0, 0};   // pos, vel, kp, kd, tau
+    uint32_t since_full = 0;
+    uint32_t hold = 0;                  // hold_full 중첩 수
+    bool     valid = false;
+  };
+
+  std::string encode_locked(const std::vector<uint8_t>& ids,
+                            const std::vector<float>& pos, const std::vector<float>& vel,
+                            const std::vector<float>& kp,  const std::vector<float>& kd,
+                            const std::vector<float>& tau);
+  void invalidate_locked(const std::vector<uint8_t>& ids);
+
+  std::mutex m_;
+  std::atomic<bool> enabled_{false};   // operation_control 분기용 (락 없이 조회)
+  int  refresh_every_ = 50;
+  uint32_t hold_all_ = 0;              // 0xFF hold_full 중첩 수
+  std::array<Last, 256> last_{};
+};
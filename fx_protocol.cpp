@@ -0,0 +1,129 @@
+#include "fx_protocol.h"
+
+#include <cctype>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+namespace fx_proto {
+
+void trim(std::string &s) {
+    size_t b = s.find_first_not_of(" \t\r\n");
+    if (b == std::string::npos) { s.clear(); return; }
+    size_t e = s.find_last_not_of(" \t\r\n");
+    s.assign(s, b, e - b + 1);
+}
+
+std::string upper_copy(std::string s) {
+    for (char &c : s)
+        c = static_cast<char>(::toupper(static_cast<unsigned char>(c)));
+    return s;
+}
+
+bool extract_tag_word(const std::string &resp, std::string &out_word) {
+    auto l = resp.find('<');
+    auto r = resp.find('>');
+    if (l == std::string::npos || r == std::string::npos || r <= l + 1) return false;
+    std::string inside = resp.substr(l + 1, r - l - 1);
+    trim(inside);
+    if (inside.empty()) return false;
+    size_t cut = inside.find_first_of(" \t(");
+    out_word = (cut == std::string::npos) ? inside : inside.substr(0, cut);
+    trim(out_word);
+    return !out_word.empty();
+}
+
+void verify_ack_or_throw(const std::string &resp, const char *expect_tag) {
+    if (resp.empty()) throw std::runtime_error("Timeout or empty reply from MCU");
+
+    std::string s = resp;
+    trim(s);
+    std::string su = upper_copy(s);
+    if (su.rfind("OK", 0) != 0)
+        throw std::runtime_error("Unexpected reply (no OK): " + s);
+
+    std::string tag;
+    if (!extract_tag_word(s, tag))
+        throw std::runtime_error("Missing <TAG> in reply: " + s);
+
+    if (upper_copy(tag) != upper_copy(expect_tag))
+        throw std::runtime_error("ACK TAG mismatch: expected '" +
+                                 std::string(expect_tag) + "' got '" + tag + "'");
+}
+
+std::string format_float(float v) {
+    std::ostringstream ss;
+    ss << std::setprecision(6) << std::fixed << v;
+    std::string s = ss.str();
+    size_t pos = s.find_last_not_of('0');
+    if (pos != std::string::npos) {
+        if (s[pos] == '.') s.erase(pos + 2);
+        else s.erase(pos + 1);
+    }
+    return s;
+}
+
+std::string build_id_group(const std::vector<uint8_t> &ids) {
+    std::ostringstream oss;
+    oss << '<';
+    for (size_t i = 0; i < ids.size(); ++i) {
+        if (i) oss << ' ';
+        oss << static_cast<unsigned>(ids[i]);
+    }
+    oss << '>';
+    return oss.str();
+}
+
+std::string encode_mit(const std::vector<uint8_t> &ids,
+                       const std::vector<float> &pos,
+                       const std::vector<float> &vel,
+                       const std::vector<float> &kp,
+                       const std::vector<float> &kd,
+                       const std::vector<float> &tau) {
+    const size_t n = ids.size();
+    std::ostringstream oss;
+    oss << "AT+MIT ";
+    for (size_t i = 0; i < n; ++i) {
+        oss << '<' << static_cast<unsigned>(ids[i]) << ' '
+            << format_float(pos[i]) << ' ' << format_float(vel[i]) << ' '
+            << format_float(kp[i])  << ' ' << format_float(kd[i])  << ' '
+            << format_float(tau[i]) << '>';
+        if (i + 1 < n) oss << ' ';
+    }
+    return oss.str();
+}
+
+bool ok_tag_upper(const std::string &resp, std::string &out_tag_upper) {
+    if (resp.size() < 2 ||
+        ::toupper(static_cast<unsigned char>(resp[0])) != 'O' ||
+        ::toupper(static_cast<unsigned char>(resp[1])) != 'K')
+        return false;
+    if (!extract_tag_word(resp, out_tag_upper)) return false;
+    for (char &c : out_tag_upper)
+        c = static_cast<char>(::toupper(static_cast<unsigned char>(c)));
+    return true;
+}
+
+bool find_uptime_ticks(const std::string &resp, int64_t &out_ticks) {
+    static const char key[] = "uptime:";
+    const size_t klen = sizeof(key) - 1;
+    for (size_t i = 0; i + klen <= resp.size(); ++i) {
+        size_t k = 0;
+        while (k < klen &&
+               ::tolower(static_cast<unsigned char>(resp[i + k])) == key[k]) ++k;
+        if (k != klen) continue;
+
+        size_t p = i + klen;
+        while (p < resp.size() && (resp[p] == ' ' || resp[p] == '\t')) ++p;
+        if (p >= resp.size() || !std::isdigit(static_cast<unsigned char>(resp[p])))
+            return false;
+        int64_t v = 0;
+        while (p < resp.size() && std::isdigit(static_cast<unsigned char>(resp[p])))
+            v = v * 10 + (resp[p++] - '0');
+        out_ticks = v;
+        return true;
+    }
+    return false;
+}
+
+} // namespace fx_proto
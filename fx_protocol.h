@@ -0,0 +1,47 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+
+// AT 프로토콜 인코딩/응답 매칭 유틸 (내부용)
+// - fx_client.cpp 와 벤치마크(bench/fx_cli_bench.cpp)가 동일한 구현을 공유
+namespace fx_proto {
+
+// 수신 패킷 (RX 스레드가 큐에 적재)
+struct RxPacket {
+  std::string data;
+  std::chrono::steady_clock::time_point t_arrival;
+};
+
+void trim(std::string &s);
+std::string upper_copy(std::string s);
+
+// "OK <TAG>; ..." 혹은 "OK <TAG> ..." 에서 <TAG> 추출
+bool extract_tag_word(const std::string &resp, std::string &out_word);
+
+// OK 응답 검증 (단발용)
+void verify_ack_or_throw(const std::string &resp, const char *expect_tag);
+
+// float -> 문자열 변환
+std::string format_float(float v);
+
+// ID 그룹 빌드: "<1 2 3>"
+std::string build_id_group(const std::vector<uint8_t> &ids);
+
+// "AT+MIT <id pos vel kp kd tau> ..." 인코딩 (길이 검증은 호출측 책임)
+std::string encode_mit(const std::vector<uint8_t> &ids,
+                       const std::vector<float> &pos,
+                       const std::vector<float> &vel,
+                       const std::vector<float> &kp,
+                       const std::vector<float> &kd,
+                       const std::vector<float> &tau);
+
+// "OK <TAG> ..." 패킷이면 대문자 TAG 를 out_tag_upper 에 담고 true
+bool ok_tag_upper(const std::string &resp, std::string &out_tag_upper);
+
+// 응답 내 "uptime:<n>" 값(MCU tick) 추출 (키 대소문자 무시)
+bool find_uptime_ticks(const std::string &resp, int64_t &out_ticks);
+
+} // namespace fx_proto
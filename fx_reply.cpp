@@ -0,0 +1,289 @@
+#include "fx_reply.h"
+#include "fx_trace.h"
+
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+using sv = std::string_view;
+
+inline bool is_trim_ws(char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
+inline bool is_item_ws(char c) { return c == ' ' || c == '\t'; }
+
+inline bool is_ident_char(char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '[' || c == ']';
+}
+
+inline sv trim(sv s) {
+    size_t b = 0, e = s.size();
+    while (b < e && is_trim_ws(s[b])) ++b;
+    while (e > b && is_trim_ws(s[e - 1])) --e;
+    return s.substr(b, e - b);
+}
+
+inline bool iequals(sv a, const char *b) {
+    const size_t n = std::strlen(b);
+    if (a.size() != n) return false;
+    for (size_t i = 0; i < n; ++i)
+        if (std::toupper(static_cast<unsigned char>(a[i])) != b[i]) return false;
+    return true;
+}
+
+// 다음 항목 경계: p 이후 첫 ",<ws><ident>:" 의 콤마 위치 (없으면 끝)
+inline size_t find_boundary(sv r, size_t p) {
+    const size_t n = r.size();
+    for (size_t i = p; i < n; ++i) {
+        if (r[i] != ',') continue;
+        size_t look = i + 1;
+        while (look < n && is_item_ws(r[look])) ++look;
+        size_t t = look;
+        while (t < n && is_ident_char(r[t])) ++t;
+        if (t > look && t < n && r[t] == ':') return i;
+    }
+    return n;
+}
+
+// strtol/strtod 는 NUL 종료 문자열이 필요 → 짧은 값은 스택 버퍼 사용
+struct CStr {
+    char buf[64];
+    std::string heap;
+    const char *p;
+    explicit CStr(sv v) {
+        if (v.size() < sizeof(buf)) {
+            std::memcpy(buf, v.data(), v.size());
+            buf[v.size()] = '\0';
+            p = buf;
+        } else {
+            heap.assign(v.data(), v.size());
+            p = heap.c_str();
+        }
+    }
+};
+
+} // namespace
+
+FxReply FxReply::parse(std::string text) {
+    FX_TRACE_SPAN(parse);
+    FxReply r;
+    r.text_ = std::move(text);
+    const sv all(r.text_);
+
+    // 구분자 개수로 상한 예약 → 파싱 중 재할당 없음
+    size_t n_semi = 1, n_colon = 0;
+    for (char c : all) {
+        n_semi  += (c == ';');
+        n_colon += (c == ':');
+    }
+    r.segs_.reserve(n_semi);
+    r.fields_.reserve(n_colon);
+
+    // ';' 단위 세그먼트 (앞뒤 공백 제거, 빈 세그먼트 무시)
+    size_t start = 0;
+    while (start <= all.size()) {
+        size_t semi = all.find(';', start);
+        size_t end = (semi == sv::npos) ? all.size() : semi;
+        sv seg = trim(all.substr(start, end - start));
+        if (!seg.empty()) r.parse_segment(seg);
+        if (semi == sv::npos) break;
+        start = semi + 1;
+    }
+    return r;
+}
+
+void FxReply::parse_segment(sv seg) {
+    Segment s;
+    const size_t colon = seg.find(':');
+    if (colon == sv::npos) {
+        // "OK <STATUS>" 같은 단독 토큰
+        s.head_off = offset(seg);
+        s.head_len = static_cast<uint32_t>(seg.size());
+        s.flag = true;
+        segs_.push_back(s);
+        return;
+    }
+
+    sv head = trim(seg.substr(0, colon));
+    sv rest = trim(seg.substr(colon + 1));
+    if (head.empty()) return;
+
+    s.head_off = offset(head);
+    s.head_len = static_cast<uint32_t>(head.size());
+    if (rest.empty()) {   // "ERRS[latest]:" 처럼 값이 비어있는 케이스
+        s.flag = true;
+        segs_.push_back(s);
+        return;
+    }
+
+    s.first = static_cast<uint32_t>(fields_.size());
+    parse_items(rest);
+    s.count = static_cast<uint32_t>(fields_.size()) - s.first;
+    segs_.push_back(s);
+}
+
+void FxReply::parse_items(sv r) {
+    const size_t n = r.size();
+    size_t p = 0;
+    while (p < n) {
+        while (p < n && is_item_ws(r[p])) ++p;
+        if (p >= n) break;
+        if (r[p] == ',') { ++p; continue; }   // 콤마 구분자 스킵
+
+        size_t k_end = p;
+        while (k_end < n && is_ident_char(r[k_end])) ++k_end;
+        const bool has_pair = (k_end < n && r[k_end] == ':');
+
+        Field f;
+        size_t v_end;
+        if (!has_pair) {
+            // subkey 없는 bare 값: UP/DOWN → state, 그 외 → value
+            v_end = find_boundary(r, p);
+            sv v = trim(r.substr(p, v_end - p));
+            if (!v.empty()) {
+                if (iequals(v, "UP") || iequals(v, "DOWN")) {
+                    f.key_kind = Field::KeyState;
+                    f.value.type = Value::Str;
+                    f.value.off = offset(v);
+                    f.value.len = static_cast<uint32_t>(v.size());
+                } else {
+                    f.key_kind = Field::KeyValue;
+                    f.value = scalar(v);
+                }
+                fields_.push_back(f);
+            }
+        } else {
+            // subkey:value
+            sv key = r.substr(p, k_end - p);
+            f.key_off = offset(key);
+            f.key_len = static_cast<uint32_t>(key.size());
+
+            p = k_end + 1;
+            while (p < n && is_item_ws(r[p])) ++p;
+            v_end = find_boundary(r, p);
+            sv v = trim(r.substr(p, v_end - p));
+
+            if (v.empty()) {
+                f.value.type = Value::Bool;
+            } else if (v.find(',') != sv::npos) {
+                // 값 내부 콤마 → 리스트 (마지막 콤마 뒤 빈 항목은 버림)
+                f.value.type = Value::List;
+                f.value.off = static_cast<uint32_t>(items_.size());
+                size_t q = 0;
+                while (q < v.size()) {
+                    size_t c = v.find(',', q);
+                    size_t e = (c == sv::npos) ? v.size() : c;
+                    items_.push_back(scalar(trim(v.substr(q, e - q))));
+                    if (c == sv::npos) break;
+                    q = c + 1;
+                }
+                f.value.len = static_cast<uint32_t>(items_.size()) - f.value.off;
+            } else {
+                f.value = scalar(v);
+            }
+            fields_.push_back(f);
+        }
+
+        if (v_end >= n) break;
+        p = v_end + 1;
+    }
+}
+
+// 정수('.' 없음) → 실수 → 문자열 순으로 판별 (strtol/strtod 규칙 그대로)
+FxReply::Value FxReply::scalar(sv v) const {
+    Value out;
+    out.type = Value::Str;
+    out.off = offset(v);
+    out.len = static_cast<uint32_t>(v.size());
+    if (v.empty()) return out;
+
+    // 숫자로 시작할 수 없는 문자면 strto* 호출 생략 (inf/nan 은 strtod 가 허용하므로 예외)
+    const char c0 = v[0];
+    if (std::isalpha(static_cast<unsigned char>(c0)) &&
+        c0 != 'i' && c0 != 'I' && c0 != 'n' && c0 != 'N')
+        return out;
+
+    CStr cs(v);
+    char *end = nullptr;
+    if (v.find('.') == sv::npos) {
+        long iv = std::strtol(cs.p, &end, 10);
+        if (end != cs.p && *end == '\0') {
+            out.type = Value::Int;
+            out.i = iv;
+            return out;
+        }
+    }
+    double dv = std::strtod(cs.p, &end);
+    if (end != cs.p && *end == '\0') {
+        out.type = Value::Float;
+        out.f = dv;
+    }
+    return out;
+}
+
+FxReply::Range<FxReply::Field> FxReply::fields(const Segment& s) const {
+    const Field *b = fields_.data() + s.first;
+    return {b, b + s.count};
+}
+
+FxReply::Range<FxReply::Value> FxReply::list(const Value& v) const {
+    if (v.type != Value::List) return {nullptr, nullptr};
+    const Value *b = items_.data() + v.off;
+    return {b, b + v.len};
+}
+
+sv FxReply::head(const Segment& s) const {
+    return sv(text_).substr(s.head_off, s.head_len);
+}
+
+sv FxReply::key(const Field& f) const {
+    switch (f.key_kind) {
+    case Field::KeyState: return "state";
+    case Field::KeyValue: return "value";
+    default:              return sv(text_).substr(f.key_off, f.key_len);
+    }
+}
+
+sv FxReply::str(const Value& v) const {
+    if (v.type != Value::Str) return sv();
+    return sv(text_).substr(v.off, v.len);
+}
+
+const FxReply::Segment* FxReply::find(sv h) const {
+    for (auto it = segs_.rbegin(); it != segs_.rend(); ++it)
+        if (head(*it) == h) return &*it;
+    return nullptr;
+}
+
+const FxReply::Value* FxReply::get(sv h, sv k) const {
+    const Segment *s = find(h);
+    if (!s || s->flag) return nullptr;
+    auto fs = fields(*s);
+    for (const Field *f = fs.e; f != fs.b; ) {
+        --f;
+        if (key(*f) == k) return &f->value;
+    }
+    return nullptr;
+}
+
+bool FxReply::get_int(sv h, sv k, long& out) const {
+    const Value *v = get(h, k);
+    if (!v || v->type != Value::Int) return false;
+    out = v->i;
+    return true;
+}
+
+bool FxReply::get_double(sv h, sv k, double& out) const {
+    const Value *v = get(h, k);
+    if (!v) return false;
+    if (v->type == Value::Float) { out = v->f; return true; }
+    if (v->type == Value::Int)   { out = static_cast<double>(v->i); return true; }
+    return false;
+}
+
+bool FxReply::get_str(sv h, sv k, std::string& out) const {
+    const Value *v = get(h, k);
+    if (!v || v->type != Value::Str) return false;
+    out.assign(str(*v));
+    return true;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// MCU 응답 구조화 파서 (REQ/STATUS/WHOAMI/PING 공통)
+//  "OK <STATUS>;MCU:fw:1.1.0, proto:ATv1, uptime:28761;NET:up, ip:...;EMERGENCY:OFF;"
+//   → 세그먼트(';' 단위) 목록
+//     - "OK <STATUS>"            : 단독 토큰(flag)
+//     - "MCU" {fw:"1.1.0", proto:"ATv1", uptime:28761}
+//     - "NET" {state:"up", ip:"..."}    (subkey 없는 UP/DOWN → state, 그 외 → value)
+//     - 값에 ',' 가 있으면 리스트, 정수/실수/문자열 자동 판별
+// - 원문을 소유하고 키/문자열 값은 원문 구간(offset/len)으로 참조 → 파싱 중 문자열 복사 없음
+// - 단일 전방 스캔(linear time)
+// - 같은 head/key 가 반복되면 마지막 값이 유효 (Python dict 변환 결과와 동일)
+class FxReply {
+public:
+  struct Value {
+    enum Type : uint8_t { Bool, Int, Float, Str, List };
+    Type     type = Bool;
+    bool     b = true;
+    long     i = 0;
+    double   f = 0.0;
+    uint32_t off = 0, len = 0;    // Str: 원문 구간, List: 리스트 항목 인덱스 범위
+  };
+
+  struct Field {
+    enum KeyKind : uint8_t { KeyText, KeyState, KeyValue };   // State/Value: bare 값의 합성 키
+    KeyKind  key_kind = KeyText;
+    uint32_t key_off = 0, key_len = 0;
+    Value    value;
+  };
+
+  struct Segment {
+    uint32_t head_off = 0, head_len = 0;
+    bool     flag = false;        // 단독 토큰 또는 값 없음 → true
+    uint32_t first = 0, count = 0;  // fields 범위
+  };
+
+  template <class T>
+  struct Range {
+    const T *b, *e;
+    const T *begin() const { return b; }
+    const T *end()   const { return e; }
+    size_t size() const { return static_cast<size_t>(e - b); }
+  };
+
+  FxReply() = default;
+  static FxReply parse(std::string text);
+
+  bool empty() const { return segs_.empty(); }
+  std::string_view text() const { return text_; }
+
+  // 순회
+  const std::vector<Segment>& segments() const { return segs_; }
+  Range<Field> fields(const Segment& s) const;
+  Range<Value> list(const Value& v) const;
+  std::string_view head(const Segment& s) const;
+  std::string_view key(const Field& f) const;
+  std::string_view str(const Value& v) const;
+
+  // 조회 (없으면 nullptr)
+  const Segment* find(std::string_view head) const;
+  const Value*   get(std::string_view head, std::string_view key) const;
+
+  // 형 변환 조회 (없거나 형이 맞지 않으면 false)
+  bool get_int   (std::string_view head, std::string_view key, long& out) const;
+  bool get_double(std::string_view head, std::string_view key, double& out) const; // Int 허용
+  bool get_str   (std::string_view head, std::string_view key, std::string& out) const;
+
+private:
+  void parse_segment(std::string_view seg);
+  void parse_items(std::string_view rest);
+  Value scalar(std::string_view v) const;
+  uint32_t offset(std::string_view v) const {
+    return static_cast<uint32_t>(v.data() - text_.data());
+  }
+
+  std::string text_;
+  std::vector<Segment> segs_;
+  std::vector<Field> fields_;
+  std::vector<Value> items_;
+};
@@ -0,0 +1,129 @@
+#include "fx_reply_router.h"
+
+#include <algorithm>
+
+namespace fx_proto {
+
+using Clock = std::chrono::steady_clock;
+
+ReplyRouter::ReplyRouter(size_t max_backlog)
+: max_backlog_(max_backlog) {}
+
+ReplyRouter::Ticket ReplyRouter::expect(const std::string &tag_upper) {
+    auto t = std::make_shared<Pending>();
+    t->tag = tag_upper;
+
+    std::lock_guard<std::mutex> lk(m_);
+    t->seq = next_seq_++;
+    t->t_expect = Clock::now();
+    auto &dq = table_[tag_upper];
+    purge_expired_locked(dq, Clock::now());
+    dq.push_back(t);
+    return t;
+}
+
+bool ReplyRouter::await(const Ticket &t, RxPacket &out, int timeout_ms) {
+    std::unique_lock<std::mutex> lk(m_);
+    if (timeout_ms > 0) {
+        auto deadline = Clock::now() + std::chrono::milliseconds(timeout_ms);
+        t->cv.wait_until(lk, deadline, [&t] { return t->done; });
+    }
+    if (t->done) {
+        out = std::move(t->pkt);
+        return true;
+    }
+    // 늦은 응답이 다음 요청으로 새지 않도록 대기시간만큼 더 자리를 지킴
+    t->orphan = true;
+    t->expire = Clock::now() + std::chrono::milliseconds(std::max(timeout_ms, 1));
+    return false;
+}
+
+void ReplyRouter::cancel(const Ticket &t) {
+    std::lock_guard<std::mutex> lk(m_);
+    auto it = table_.find(t->tag);
+    if (it == table_.end()) return;
+    auto &dq = it->second;
+    dq.erase(std::remove(dq.begin(), dq.end(), t), dq.end());
+}
+
+void ReplyRouter::purge_expired_locked(std::deque<Ticket> &dq, Clock::time_point now) {
+    while (!dq.empty() && dq.front()->orphan && dq.front()->expire < now)
+        dq.pop_front();
+}
+
+void ReplyRouter::dispatch(RxPacket &&pkt) {
+    std::string tag;
+    const bool is_ok = ok_tag_upper(pkt.data, tag);   // 파싱은 락 밖에서 1회
+
+    std::unique_lock<std::mutex> lk(m_);
+    if (is_ok) {
+        auto it = table_.find(tag);
+        if (it != table_.end()) {
+            auto &dq = it->second;
+            purge_expired_locked(dq, pkt.t_arrival);
+            auto live = std::find_if(dq.begin(), dq.end(),
+                                     [](const Ticket &t) { return !t->orphan; });
+            if (!dq.empty() && dq.front()->orphan &&
+                (live == dq.end() || pkt.t_arrival < (*live)->t_expect)) {
+                // 새 요청 등록 전에 도착 → 타임아웃된 이전 요청의 늦은 응답, 폐기
+                dq.pop_front();
+                ++late_drops_;
+                return;
+            }
+            if (live != dq.end()) {
+                // 앞선 orphan 들은 응답 유실로 간주하고 함께 제거
+                Ticket t = std::move(*live);
+                dq.erase(dq.begin(), live + 1);
+                t->pkt = std::move(pkt);
+                t->done = true;
+                lk.unlock();
+                t->cv.notify_one();
+                return;
+            }
+        }
+    }
+
+    if (backlog_.size() >= max_backlog_) {
+        // 오래된 것부터 드랍
+        backlog_.pop_front();
+    }
+    backlog_.push_back(std::move(pkt));
+    lk.unlock();
+    backlog_cv_.notify_all();
+}
+
+void ReplyRouter::flush_backlog() {
+    std::lock_guard<std::mutex> lk(m_);
+    backlog_.clear();
+}
+
+bool ReplyRouter::wait_for_any(std::string &out, int timeout_ms) {
+    auto deadline = Clock::now() + std::chrono::milliseconds(timeout_ms > 0 ? timeout_ms : 0);
+    std::unique_lock<std::mutex> lk(m_);
+    auto pred = [this, &out]() -> bool {
+        if (!backlog_.empty()) {
+            out = backlog_.back().data;
+            backlog_.clear();
+            return true;
+        }
+        return false;
+    };
+    if (timeout_ms <= 0) return pred();
+    return backlog_cv_.wait_until(lk, deadline, pred);
+}
+
+size_t ReplyRouter::inflight() const {
+    std::lock_guard<std::mutex> lk(m_);
+    size_t n = 0;
+    for (const auto &kv : table_)
+        for (const auto &t : kv.second)
+            if (!t->orphan) ++n;
+    return n;
+}
+
+uint64_t ReplyRouter::late_drops() const {
+    std::lock_guard<std::mutex> lk(m_);
+    return late_drops_;
+}
+
+} // namespace fx_proto
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "fx_protocol.h"
+
+namespace fx_proto {
+
+// 진행 중(in-flight) 요청 테이블 기반 응답 분배기 (내부용)
+// - 요청 스레드: 송신 "전에" expect(TAG) 로 티켓 등록 → await() 로 자기 응답만 대기
+// - RX 스레드  : dispatch() 가 "OK <TAG>" 를 해당 TAG 의 가장 오래된 티켓에 전달 (TAG 별 FIFO)
+// - 응답이 자기 티켓으로만 전달되므로 큐 flush 가 필요 없고, 스레드 간 서로의 응답을 지우지 않음
+// - 타임아웃 티켓은 orphan 으로 잠시 남겨, 뒤늦게 온 응답이 다음 요청에 잘못 매칭되지 않게 소비
+//   * 단, 같은 TAG 의 새 요청이 등록된 뒤 도착한 응답은 새 요청 것으로 보고 orphan 은 폐기
+//     (응답 유실 1건이 뒤따르는 요청들의 응답을 연쇄적으로 삼키지 않도록)
+// - 대기자가 없는 패킷은 backlog(최대 max_backlog, 오래된 것부터 드랍)에 보관
+class ReplyRouter {
+public:
+  struct Pending {
+    std::string tag;                 // 대문자 TAG
+    uint64_t seq = 0;                // 등록 순번 (전체 단조 증가)
+    std::chrono::steady_clock::time_point t_expect;   // 등록 시각 (송신 직전)
+    bool done = false;
+    bool orphan = false;             // 대기 타임아웃 → 늦은 응답 흡수용
+    std::chrono::steady_clock::time_point expire;
+    std::condition_variable cv;
+    RxPacket pkt;
+  };
+  using Ticket = std::shared_ptr<Pending>;
+
+  explicit ReplyRouter(size_t max_backlog = 256);
+
+  // 요청 등록 (송신 전 호출, 송신 순서와 등록 순서가 같아야 함)
+  Ticket expect(const std::string &tag_upper);
+
+  // 티켓 응답 대기. timeout_ms <= 0 이면 논블로킹
+  // - 실패 시 티켓은 orphan 으로 전환 (timeout 만큼 늦은 응답을 흡수)
+  bool await(const Ticket &t, RxPacket &out, int timeout_ms);
+
+  // 송신 실패 등으로 등록 취소
+  void cancel(const Ticket &t);
+
+  // RX 스레드에서 수신 패킷 분배
+  void dispatch(RxPacket &&pkt);
+
+  // backlog (대기자 없던 패킷) 관리
+  void flush_backlog();
+  bool wait_for_any(std::string &out, int timeout_ms);
+
+  size_t inflight() const;
+  uint64_t late_drops() const;
+
+private:
+  void purge_expired_locked(std::deque<Ticket> &dq,
+                            std::chrono::steady_clock::time_point now);
+
+  mutable std::mutex m_;
+  std::condition_variable backlog_cv_;
+  std::unordered_map<std::string, std::deque<Ticket>> table_;
+  std::deque<RxPacket> backlog_;
+  size_t max_backlog_;
+  uint64_t next_seq_ = 0;
+  uint64_t late_drops_ = 0;
+};
+
+} // namespace fx_proto
@@ -0,0 +1,348 @@
+#include "fx_sim.h"
+#include "fx_protocol.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+// "AT+CMD args" → (대문자 CMD, args)
+bool split_command(const std::string &cmd, std::string &name, std::string &args) {
+    if (cmd.size() < 3 || cmd.compare(0, 3, "AT+") != 0) return false;
+    size_t e = 3;
+    while (e < cmd.size() && !std::isspace(static_cast<unsigned char>(cmd[e]))) ++e;
+    name.assign(cmd, 3, e - 3);
+    for (char &c : name) c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    args.assign(cmd, e, std::string::npos);
+    return true;
+}
+
+// ID 그룹 "<1 2 3 ...> ..." → 전체 ID 목록 (그룹당 개수 제한 없음, 숫자가 아닌 토큰에서 그룹 종료)
+std::vector<long> parse_id_groups(const std::string &args) {
+    std::vector<long> ids;
+    size_t p = 0;
+    while ((p = args.find('<', p)) != std::string::npos) {
+        const size_t close = args.find('>', p);
+        if (close == std::string::npos) break;
+        const std::string body = args.substr(p + 1, close - p - 1);
+        const char *s = body.c_str();
+        for (;;) {
+            char *end = nullptr;
+            const long id = std::strtol(s, &end, 10);
+            if (end == s) break;
+            ids.push_back(id);
+            s = end;
+        }
+        p = close + 1;
+    }
+    return ids;
+}
+
+// MIT 그룹 "<id p v kp kd tau> ..." 의 각 그룹을 숫자 배열로 (최대 8개, 숫자가 아닌 토큰에서 그룹 종료)
+template <class Fn>
+void for_each_group(const std::string &args, Fn &&fn) {
+    double vals[8];
+    size_t p = 0;
+    while ((p = args.find('<', p)) != std::string::npos) {
+        const size_t close = args.find('>', p);
+        if (close == std::string::npos) break;
+        const std::string body = args.substr(p + 1, close - p - 1);
+        const char *s = body.c_str();
+        int n = 0;
+        while (n < 8) {
+            char *end = nullptr;
+            const double v = std::strtod(s, &end);
+            if (end == s) break;
+            vals[n++] = v;
+            s = end;
+        }
+        fn(vals, n);
+        p = close + 1;
+    }
+}
+
+// AT+MITD 그룹 "<id p<v> v<v> k<v> d<v> t<v>>" → (id, 필드 존재 mask, 값[5])
+template <class Fn>
+void for_each_delta_group(const std::string &args, Fn &&fn) {
+    static const char kTags[] = "pvkdt";
+    size_t p = 0;
+    while ((p = args.find('<', p)) != std::string::npos) {
+        const size_t close = args.find('>', p);
+        if (close == std::string::npos) break;
+        const std::string body = args.substr(p + 1, close - p - 1);
+        const char *s = body.c_str();
+        char *end = nullptr;
+        const long id = std::strtol(s, &end, 10);
+        if (end != s) {
+            double vals[5] = {0, 0, 0, 0, 0};
+            unsigned mask = 0;
+            s = end;
+            for (;;) {
+                while (*s == ' ' || *s == '\t') ++s;
+                const char *tag = *s ? std::strchr(kTags, *s) : nullptr;
+                if (!tag) break;
+                const double v = std::strtod(s + 1, &end);
+                if (end == s + 1) break;
+                const int f = static_cast<int>(tag - kTags);
+                vals[f] = v;
+                mask |= 1u << f;
+                s = end;
+            }
+            fn(id, mask, vals);
+        }
+        p = close + 1;
+    }
+}
+
+} // namespace
+
+FxSimMcu::FxSimMcu(double dt)
+: dt_(dt) {
+    if (!(dt > 0.0) || !std::isfinite(dt))
+        throw std::invalid_argument("dt must be positive");
+}
+
+void FxSimMcu::add_motor(uint8_t id, const FxSimMotorParams &params) {
+    if (!(params.inertia > 0.0) || params.damping < 0.0 || params.tau_max < 0.0)
+        throw std::invalid_argument("invalid motor parameters");
+    std::lock_guard<std::mutex> lk(m_);
+    motors_[id].params = params;
+}
+
+void FxSimMcu::step(int n) {
+    std::lock_guard<std::mutex> lk(m_);
+    for (int i = 0; i < n; ++i) {
+        for (auto &kv : motors_) integrate(kv.second);
+        ++steps_;
+    }
+}
+
+// semi-implicit Euler: 비포화 시 kp/kd/b 항을 v_next 에 대해 암시적으로 풀고,
+// 포화되면 토크 고정 후 감쇠 항만 암시적으로 적분
+void FxSimMcu::integrate(Motor &m) const {
+    const double J = m.params.inertia, b = m.params.damping, h = dt_;
+    const double p = m.pos - m.zero;
+    double v_next, tau;
+
+    if (m.enabled) {
+        const double kp = m.kp, kd = m.kd;
+        v_next = (J / h * m.vel + kp * (m.p_des - p) + kd * m.v_des + m.tau_ff)
+               / (J / h + kp * h + kd + b);
+        tau = kp * (m.p_des - (p + h * v_next)) + kd * (m.v_des - v_next) + m.tau_ff;
+        const double lim = m.params.tau_max;
+        if (tau > lim || tau < -lim) {
+            tau = std::max(-lim, std::min(lim, tau));
+            v_next = (J / h * m.vel + tau) / (J / h + b);
+        }
+    } else {
+        tau = 0.0;
+        v_next = (J / h * m.vel) / (J / h + b);
+    }
+
+    m.vel = v_next;
+    m.pos += h * v_next;
+    m.tau = tau;
+}
+
+FxSimMotorState FxSimMcu::motor(uint8_t id) const {
+    std::lock_guard<std::mutex> lk(m_);
+    const Motor &m = motors_.at(id);
+    FxSimMotorState st;
+    st.pos = m.pos - m.zero;
+    st.vel = m.vel;
+    st.tau = m.tau;
+    st.enabled = m.enabled;
+    return st;
+}
+
+void FxSimMcu::set_motor(uint8_t id, double pos, double vel) {
+    std::lock_guard<std::mutex> lk(m_);
+    Motor &m = motors_.at(id);
+    m.pos = pos + m.zero;
+    m.vel = vel;
+    m.tau = 0.0;
+}
+
+void FxSimMcu::reset() {
+    std::lock_guard<std::mutex> lk(m_);
+    for (auto &kv : motors_) {
+        const FxSimMotorParams params = kv.second.params;
+        kv.second = Motor{};
+        kv.second.params = params;
+    }
+    steps_ = 0;
+    seq_ = 0;
+    emergency_ = false;
+}
+
+double FxSimMcu::time() const {
+    std::lock_guard<std::mutex> lk(m_);
+    return static_cast<double>(steps_) * dt_;
+}
+
+uint64_t FxSimMcu::steps() const {
+    std::lock_guard<std::mutex> lk(m_);
+    return steps_;
+}
+
+void FxSimMcu::drop_replies(const std::string &tag, int n) {
+    std::lock_guard<std::mutex> io(io_m_);
+    if (n > 0) drop_[tag] += n;
+    else       drop_.erase(tag);
+}
+
+// ---- FxTransport ----
+void FxSimMcu::start(RxFn on_rx) {
+    std::lock_guard<std::mutex> io(io_m_);
+    on_rx_ = std::move(on_rx);
+}
+
+void FxSimMcu::stop() {
+    std::lock_guard<std::mutex> io(io_m_);
+    on_rx_ = nullptr;
+}
+
+void FxSimMcu::send(const char *data, size_t len) {
+    // 처리 순서 == 응답 전달 순서 (같은 TAG 응답이 요청 순서대로 매칭되도록)
+    std::lock_guard<std::mutex> io(io_m_);
+    std::string reply;
+    {
+        std::lock_guard<std::mutex> lk(m_);
+        reply = handle_locked(std::string(data, len));
+    }
+    if (reply.empty() || !on_rx_) return;
+    if (!drop_.empty()) {
+        std::string tag;
+        auto it = fx_proto::ok_tag_upper(reply, tag) ? drop_.find(tag) : drop_.end();
+        if (it != drop_.end()) {
+            if (--it->second <= 0) drop_.erase(it);
+            return;
+        }
+    }
+    // 응답은 상태 락 밖에서 전달 (수신측에서 step()/motor() 조회 가능)
+    on_rx_(std::move(reply), std::chrono::steady_clock::now());
+}
+
+// ---- 명령 처리 ----
+std::string FxSimMcu::handle_locked(const std::string &cmd) {
+    std::string name, args;
+    if (!split_command(cmd, name, args)) return std::string();
+
+    if (name == "MIT") {
+        apply_mit_locked(args);
+        return std::string();   // 실제 MCU 와 동일하게 무응답
+    }
+    if (name == "MITD") {
+        apply_mit_delta_locked(args);
+        return std::string();
+    }
+    if (name == "REQ")    return encode_req_locked(args);
+    if (name == "STATUS") return encode_status_locked();
+    if (name == "PING")   return "OK <PING>;";
+    if (name == "WHOAMI") return "OK <WHOAMI>;MCU:name:fx-sim, fw:sim, proto:ATv1;";
+
+    if (name == "START" || name == "STOP" || name == "ESTOP" || name == "SETZERO") {
+        for (Motor *m : select_locked(args)) {
+            if (name == "START") {
+                // 현재 자세 유지로 시작 (이전 setpoint 로 튀지 않도록)
+                m->enabled = true;
+                m->p_des = static_cast<float>(m->pos - m->zero);
+                m->v_des = m->kp = m->kd = m->tau_ff = 0.0f;
+            } else if (name == "SETZERO") {
+                m->zero = m->pos;
+            } else {
+                m->enabled = false;
+            }
+        }
+        if (name == "ESTOP") emergency_ = true;
+        if (name == "START") emergency_ = false;
+        return "OK <" + name + ">;";
+    }
+    return std::string();
+}
+
+std::vector<FxSimMcu::Motor *> FxSimMcu::select_locked(const std::string &args) {
+    std::vector<Motor *> out;
+    for (long id : parse_id_groups(args)) {
+        if (id == 0xFF) {
+            out.clear();
+            for (auto &kv : motors_) out.push_back(&kv.second);
+            return out;
+        }
+        auto it = motors_.find(static_cast<uint8_t>(id));
+        if (it != motors_.end()) out.push_back(&it->second);
+    }
+    return out;
+}
+
+void FxSimMcu::apply_mit_locked(const std::string &args) {
+    for_each_group(args, [&](const double *v, int n) {
+        if (n < 6) return;
+        auto it = motors_.find(static_cast<uint8_t>(v[0]));
+        if (it == motors_.end() || !it->second.enabled) return;
+        Motor &m = it->second;
+        m.p_des  = static_cast<float>(v[1]);
+        m.v_des  = static_cast<float>(v[2]);
+        m.kp     = static_cast<float>(v[3]);
+        m.kd     = static_cast<float>(v[4]);
+        m.tau_ff = static_cast<float>(v[5]);
+    });
+}
+
+// 그룹에 있는 필드만 갱신, 나머지는 직전 setpoint 유지
+void FxSimMcu::apply_mit_delta_locked(const std::string &args) {
+    for_each_delta_group(args, [&](long id, unsigned mask, const double *v) {
+        auto it = motors_.find(static_cast<uint8_t>(id));
+        if (it == motors_.end() || !it->second.enabled) return;
+        Motor &m = it->second;
+        float *dst[5] = {&m.p_des, &m.v_des, &m.kp, &m.kd, &m.tau_ff};
+        for (int f = 0; f < 5; ++f)
+            if (mask & (1u << f)) *dst[f] = static_cast<float>(v[f]);
+    });
+}
+
+std::string FxSimMcu::encode_req_locked(const std::string &args) {
+    std::string s = "OK <REQ>;";
+    char buf[128];
+    auto emit = [&](uint8_t mid, const Motor &m) {
+        std::snprintf(buf, sizeof(buf), "M%u:p:%.6f, v:%.6f, t:%.6f;",
+                      static_cast<unsigned>(mid), m.pos - m.zero, m.vel, m.tau);
+        s += buf;
+    };
+    for (long id : parse_id_groups(args)) {
+        if (id == 0xFF) {
+            for (const auto &kv : motors_) emit(kv.first, kv.second);
+            continue;
+        }
+        auto it = motors_.find(static_cast<uint8_t>(id));
+        if (it != motors_.end()) emit(it->first, it->second);
+    }
+    s += "IMU:r:0.00, p:0.00, y:0.00, gx:0.00, gy:0.00, gz:0.00, pgx:0.00, pgy:0.00, pgz:1.00;";
+    std::snprintf(buf, sizeof(buf), "SEQ_NUM:cnt:%llu;", static_cast<unsigned long long>(++seq_));
+    s += buf;
+    return s;
+}
+
+std::string FxSimMcu::encode_status_locked() const {
+    std::string s = "OK <STATUS>;";
+    char buf[128];
+    std::snprintf(buf, sizeof(buf), "MCU:fw:sim, proto:ATv1, uptime:%llu;",
+                  static_cast<unsigned long long>(std::llround(steps_ * dt_ * 1000.0)));
+    s += buf;
+    s += "NET:up, ip:127.0.0.1, gw:127.0.0.1, mask:255.0.0.0;";
+    s += "QUEUE:udp_tx:0, motor_ctrl:0;";
+    for (const auto &kv : motors_) {
+        std::snprintf(buf, sizeof(buf), "M%u:pattern:%d, err:None;",
+                      static_cast<unsigned>(kv.first), kv.second.enabled ? 2 : 0);
+        s += buf;
+    }
+    s += "IMU:pattern:2, err:None;";
+    s += emergency_ ? "EMERGENCY:ON;" : "EMERGENCY:OFF;";
+    return s;
+}
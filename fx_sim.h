@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "fx_transport.h"
+
+// 시뮬레이션 모터 파라미터
+struct FxSimMotorParams {
+  double inertia = 0.01;     // 회전 관성 [kg·m²]
+  double damping = 0.02;     // 점성 마찰 [Nm·s/rad]
+  double tau_max = 10.0;     // 출력 토크 한계 [Nm]
+};
+
+// 시뮬레이션 모터 상태
+struct FxSimMotorState {
+  double pos = 0.0;          // [rad] (SETZERO 기준)
+  double vel = 0.0;          // [rad/s]
+  double tau = 0.0;          // 직전 step 에 인가된 토크 [Nm]
+  bool   enabled = false;    // START 이후 true, STOP/ESTOP 시 false
+};
+
+// 인프로세스 MCU 시뮬레이터 (FxTransport 구현)
+// - FxCli(std::shared_ptr<FxTransport>) 에 꽂아 하드웨어와 같은 API/코드 경로로 사용
+// - AT 명령을 send() 안에서 바로 처리하고 응답을 동기적으로 전달 (스레드/소켓 없음)
+// - 물리는 step() 호출 시에만 진행 (lockstep) → 결정적, 실시간보다 빠르게 실행 가능
+//
+// 모터 모델 (MIT 제어):
+//   tau = clamp(kp*(p_des - p) + kd*(v_des - v) + tau_ff, ±tau_max)
+//   J*dv/dt = tau - b*v
+//   - 비포화 구간은 kp/kd/b 항을 암시적(implicit)으로 적분 → 큰 게인/작은 관성에서도 안정
+//   - 비활성(START 전, STOP/ESTOP 후) 모터는 tau = 0
+//
+// 지원 명령: PING, WHOAMI, START, STOP, ESTOP, SETZERO, MIT, MITD(delta), REQ, STATUS
+//  - ID 255(0xFF) 는 등록된 전체 모터
+//  - 등록되지 않은 ID 는 무시
+class FxSimMcu : public FxTransport {
+public:
+  explicit FxSimMcu(double dt = 0.001);
+
+  // 모터 등록 (이미 있으면 파라미터 교체, 상태 유지)
+  void add_motor(uint8_t id, const FxSimMotorParams& params = FxSimMotorParams{});
+
+  // 물리 n step 진행 (각 dt 초)
+  void step(int n = 1);
+
+  // 상태 조회/설정 (에피소드 리셋용, 미등록 ID 는 std::out_of_range)
+  FxSimMotorState motor(uint8_t id) const;
+  void set_motor(uint8_t id, double pos, double vel);
+
+  // 모든 모터 정지/원점 복귀, 시간/시퀀스 0 으로 (파라미터 유지)
+  void reset();
+
+  // 고장 주입: TAG(대문자, 예 "REQ") 응답을 다음 n 건 전달하지 않음 (패킷 유실 재현)
+  void drop_replies(const std::string& tag, int n = 1);
+
+  double   dt() const { return dt_; }
+  double   time() const;      // 시뮬레이션 시각 [s]
+  uint64_t steps() const;
+
+  // FxTransport
+  void start(RxFn on_rx) override;
+  void send(const char* data, size_t len) override;
+  void stop() override;
+
+private:
+  struct Motor {
+    FxSimMotorParams params;
+    double pos = 0.0, vel = 0.0, tau = 0.0;
+    double zero = 0.0;               // SETZERO 오프셋
+    bool   enabled = false;
+    float  p_des = 0, v_des = 0, kp = 0, kd = 0, tau_ff = 0;
+  };
+
+  // 명령 처리 → 응답(없으면 빈 문자열)
+  std::string handle_locked(const std::string& cmd);
+  std::vector<Motor*> select_locked(const std::string& args);
+  void apply_mit_locked(const std::string& args);
+  void apply_mit_delta_locked(const std::string& args);
+  std::string encode_req_locked(const std::string& args);
+  std::string encode_status_locked() const;
+  void integrate(Motor& m) const;
+
+  const double dt_;
+  mutable std::mutex m_;
+  std::map<uint8_t, Motor> motors_;
+  uint64_t steps_ = 0;
+  uint64_t seq_ = 0;
+  bool     emergency_ = false;
+
+  std::mutex io_m_;                  // 명령 처리 + 응답 전달 직렬화, on_rx_/drop_ 보호
+  RxFn on_rx_;
+  std::map<std::string, int> drop_;  // TAG → 남은 유실 건수
+};
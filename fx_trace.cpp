@@ -0,0 +1,189 @@
+#include "fx_trace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace fx_trace {
+
+std::atomic<bool> g_enabled{false};
+
+namespace {
+
+struct Event {
+    const char *name;
+    uint64_t t0, t1;
+};
+
+// 스레드 1개 전용 링버퍼 (기록: 소유 스레드만, 읽기: dump 시 임의 스레드)
+// - head: 누적 기록 수 (release 로 공개), 슬롯 = head % capacity
+// - base: clear() 시점의 head (그 이전 기록은 무효)
+struct Buffer {
+    explicit Buffer(size_t cap) : ev(cap) {}
+    long tid = 0;
+    std::vector<Event> ev;
+    std::atomic<uint64_t> head{0};
+    std::atomic<uint64_t> base{0};
+    std::atomic<bool> exited{false};   // 소유 스레드 종료 (thread_local 소멸자에서 설정)
+};
+
+// 종료된 스레드 버퍼 보관 상한 (초과 시 오래된 것부터 폐기)
+//  - 스레드를 계속 만들고 버리는 프로세스에서 메모리가 무한히 늘지 않도록
+constexpr size_t kMaxExitedBuffers = 64;
+
+struct Registry {
+    std::mutex m;
+    std::vector<std::shared_ptr<Buffer>> bufs;   // 종료된 스레드의 기록도 (상한까지) 유지
+    size_t capacity = 1 << 16;
+};
+
+// 종료된 스레드 버퍼 정리 (keep: 남길 최대 개수, 등록 순서상 최근 것 우선)
+void prune_exited_locked(Registry &r, size_t keep) {
+    size_t exited = 0;
+    for (const auto &b : r.bufs)
+        if (b->exited.load(std::memory_order_acquire)) ++exited;
+    if (exited <= keep) return;
+    size_t drop = exited - keep;
+    auto it = std::remove_if(r.bufs.begin(), r.bufs.end(), [&drop](const std::shared_ptr<Buffer> &b) {
+        if (drop == 0 || !b->exited.load(std::memory_order_acquire)) return false;
+        --drop;
+        return true;
+    });
+    r.bufs.erase(it, r.bufs.end());
+}
+
+// 스레드 종료 시 버퍼에 종료 표시 (기록은 dump/clear 전까지 유지)
+struct LocalHolder {
+    std::shared_ptr<Buffer> buf;
+    ~LocalHolder() {
+        if (buf) buf->exited.store(true, std::memory_order_release);
+    }
+};
+
+// 스레드 종료/정적 소멸 순서와 무관하도록 해제하지 않음
+Registry &registry() {
+    static Registry *r = new Registry();
+    return *r;
+}
+
+Buffer *local_buffer() {
+    thread_local LocalHolder tl;
+    if (!tl.buf) {
+        Registry &r = registry();
+        std::lock_guard<std::mutex> lk(r.m);
+        prune_exited_locked(r, kMaxExitedBuffers);
+        tl.buf = std::make_shared<Buffer>(r.capacity);
+        tl.buf->tid = static_cast<long>(::syscall(SYS_gettid));
+        r.bufs.push_back(tl.buf);
+    }
+    return tl.buf.get();
+}
+
+// [lo, hi) 중 아직 덮어써지지 않은 구간을 복사
+void snapshot(const Buffer &b, std::vector<Event> &out) {
+    const uint64_t cap = b.ev.size();
+    const uint64_t hi = b.head.load(std::memory_order_acquire);
+    uint64_t lo = std::max<uint64_t>(b.base.load(std::memory_order_relaxed),
+                                     hi > cap ? hi - cap : 0);
+    const size_t first = out.size();
+    for (uint64_t i = lo; i < hi; ++i) out.push_back(b.ev[i % cap]);
+
+    // 복사 중 기록 스레드가 앞질러 덮어쓴 슬롯은 버림
+    const uint64_t hi2 = b.head.load(std::memory_order_acquire);
+    if (hi2 > cap && hi2 - cap > lo) {
+        const uint64_t stale = std::min<uint64_t>(hi2 - cap - lo, hi - lo);
+        out.erase(out.begin() + first, out.begin() + first + stale);
+    }
+}
+
+} // namespace
+
+void enable(bool on) {
+    g_enabled.store(on, std::memory_order_relaxed);
+}
+
+void clear() {
+    Registry &r = registry();
+    std::lock_guard<std::mutex> lk(r.m);
+    prune_exited_locked(r, 0);   // 종료된 스레드는 더 기록하지 않으므로 버퍼째 해제
+    for (auto &b : r.bufs)
+        b->base.store(b->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+}
+
+void set_buffer_capacity(size_t spans) {
+    Registry &r = registry();
+    std::lock_guard<std::mutex> lk(r.m);
+    r.capacity = std::max<size_t>(spans, 16);
+}
+
+uint64_t now_ns() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void record(const char *name, uint64_t t_begin_ns, uint64_t t_end_ns) {
+    Buffer *b = local_buffer();
+    const uint64_t h = b->head.load(std::memory_order_relaxed);
+    b->ev[h % b->ev.size()] = Event{name, t_begin_ns, t_end_ns};
+    b->head.store(h + 1, std::memory_order_release);
+}
+
+uint64_t dropped() {
+    Registry &r = registry();
+    std::lock_guard<std::mutex> lk(r.m);
+    uint64_t n = 0;
+    for (const auto &b : r.bufs) {
+        const uint64_t h = b->head.load(std::memory_order_acquire);
+        const uint64_t valid = h - std::min(h, b->base.load(std::memory_order_relaxed));
+        if (valid > b->ev.size()) n += valid - b->ev.size();
+    }
+    return n;
+}
+
+std::string chrome_json() {
+    std::vector<std::pair<long, std::vector<Event>>> per_thread;
+    {
+        Registry &r = registry();
+        std::lock_guard<std::mutex> lk(r.m);
+        per_thread.reserve(r.bufs.size());
+        for (const auto &b : r.bufs) {
+            per_thread.emplace_back(b->tid, std::vector<Event>{});
+            snapshot(*b, per_thread.back().second);
+        }
+    }
+
+    const long pid = static_cast<long>(::getpid());
+    std::string out = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    char buf[256];
+    bool first = true;
+    for (const auto &kv : per_thread) {
+        for (const Event &e : kv.second) {
+            // "X"(complete) 이벤트: ts/dur [us]
+            std::snprintf(buf, sizeof(buf),
+                          "%s{\"name\":\"%s\",\"cat\":\"fx_cli\",\"ph\":\"X\","
+                          "\"ts\":%.3f,\"dur\":%.3f,\"pid\":%ld,\"tid\":%ld}",
+                          first ? "" : ",", e.name,
+                          e.t0 / 1e3, (e.t1 - e.t0) / 1e3, pid, kv.first);
+            out += buf;
+            first = false;
+        }
+    }
+    out += "]}";
+    return out;
+}
+
+bool dump(const std::string &path) {
+    std::ofstream f(path, std::ios::out | std::ios::trunc);
+    if (!f) return false;
+    f << chrome_json();
+    return static_cast<bool>(f);
+}
+
+} // namespace fx_trace
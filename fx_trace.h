@@ -0,0 +1,79 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// 명령 경로 span 트레이싱
+// - FX_TRACE_SPAN(name): 현재 스코프를 span 으로 기록 (name 은 식별자 토큰)
+//   * 런타임 기록: fx_trace::enable(true) 일 때만 스레드별 링버퍼에 기록 (락 없음)
+//     → fx_trace::chrome_json() / dump() 로 Chrome trace(JSON, chrome://tracing, Perfetto) 출력
+//   * USDT 프로브: <sys/sdt.h> 가 있으면 fx_cli:<name>__begin / fx_cli:<name>__end 정적 프로브 생성
+//     → 기록 활성화와 무관하게 perf/bpftrace 로 attach (미연결 시 nop 1개)
+// - 비활성 비용: relaxed atomic load + 분기 1회 (FX_CLI_NO_TRACE 정의 시 완전히 제거)
+//
+// ex) bpftrace -e 'usdt:./fx_cli*.so:fx_cli:wait__begin { @t[tid] = nsecs; }
+//                  usdt:./fx_cli*.so:fx_cli:wait__end   { @us = hist((nsecs - @t[tid]) / 1000); }'
+namespace fx_trace {
+
+extern std::atomic<bool> g_enabled;
+
+inline bool enabled() { return g_enabled.load(std::memory_order_relaxed); }
+void enable(bool on);
+
+// 기록된 span 전부 폐기 (기록 중에도 호출 가능)
+//  - 종료된 스레드의 버퍼는 메모리까지 해제 (clear 없이도 최근 64개 스레드분까지만 보관)
+void clear();
+
+// 스레드별 버퍼 용량(span 수, 가득 차면 오래된 것부터 덮어씀)
+//  - 이후 처음 기록하는 스레드부터 적용
+void set_buffer_capacity(size_t spans);
+
+// Chrome trace event JSON ({"traceEvents":[...]}), ts/dur 단위 us
+std::string chrome_json();
+bool dump(const std::string& path);
+
+// 덮어써져 유실된 span 수 (전체 스레드 합)
+uint64_t dropped();
+
+uint64_t now_ns();
+void record(const char* name, uint64_t t_begin_ns, uint64_t t_end_ns);
+
+// 스코프 span (비활성 시 시각 조회/기록 없음)
+class Span {
+public:
+  explicit Span(const char* name)
+  : name_(name), t0_(enabled() ? now_ns() : 0) {}
+  ~Span() { if (t0_) record(name_, t0_, now_ns()); }
+  Span(const Span&) = delete;
+  Span& operator=(const Span&) = delete;
+
+private:
+  const char* name_;
+  uint64_t t0_;
+};
+
+} // namespace fx_trace
+
+// ---- USDT ----
+#if !defined(FX_CLI_NO_TRACE) && defined(__has_include)
+#  if __has_include(<sys/sdt.h>)
+#    include <sys/sdt.h>
+#    define FX_TRACE_USDT(probe) DTRACE_PROBE(fx_cli, probe)
+#  endif
+#endif
+#ifndef FX_TRACE_USDT
+#  define FX_TRACE_USDT(probe) do {} while (0)
+#endif
+
+// ---- span 매크로 ----
+#ifdef FX_CLI_NO_TRACE
+#  define FX_TRACE_SPAN(name) do {} while (0)
+#else
+#  define FX_TRACE_SPAN(name)                                                   \
+     FX_TRACE_USDT(name##__begin);                                              \
+     struct fx_trace_end_##name {                                               \
+       ~fx_trace_end_##name() { FX_TRACE_USDT(name##__end); }                   \
+     } fx_trace_end_probe_##name;                                               \
+     ::fx_trace::Span fx_trace_span_##name(#name)
+#endif
@@ -0,0 +1,224 @@
+#include "fx_trajectory.h"
+
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+
+#include <pthread.h>
+#include <sched.h>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+inline double to_sec(Clock::time_point tp) {
+    return std::chrono::duration<double>(tp.time_since_epoch()).count();
+}
+
+inline float lerp(float a, float b, double s) {
+    return static_cast<float>(a + (b - a) * s);
+}
+
+} // namespace
+
+FxTrajectoryStreamer::FxTrajectoryStreamer(EmitFn emit)
+: emit_(std::move(emit)) {}
+
+FxTrajectoryStreamer::~FxTrajectoryStreamer() {
+    stop();
+}
+
+void FxTrajectoryStreamer::start(const std::vector<uint8_t>& ids, double rate_hz,
+                                 FxInterp interp, int rt_priority) {
+    if (!(rate_hz > 0.0) || !std::isfinite(rate_hz))
+        throw std::invalid_argument("rate_hz must be positive");
+    if (ids.empty())
+        throw std::invalid_argument("ids must not be empty");
+
+    stop();
+
+    // 설정 교체는 load() 와 같은 락 아래에서 (load 가 ids_ 를 읽는 중 재할당 방지)
+    std::lock_guard<std::mutex> lk(load_m_);
+    ids_ = ids;
+    period_s_ = 1.0 / rate_hz;
+    interp_ = interp;
+    rt_priority_ = rt_priority;
+    std::atomic_store(&traj_, std::shared_ptr<const Trajectory>());
+    {
+        std::lock_guard<std::mutex> slk(stats_m_);
+        stats_ = FxTrajStats{};
+    }
+
+    run_.store(true);
+    th_ = std::thread([this] { this->loop(); });
+}
+
+void FxTrajectoryStreamer::stop() {
+    run_.store(false);
+    if (th_.joinable()) th_.join();
+}
+
+void FxTrajectoryStreamer::load(std::vector<FxWaypoint> wps, bool append) {
+    size_t n;
+    {
+        std::lock_guard<std::mutex> lk(load_m_);
+        if (!run_.load()) throw std::runtime_error("trajectory streamer not running");
+        n = ids_.size();
+    }
+
+    for (size_t i = 0; i < wps.size(); ++i) {
+        const auto& w = wps[i];
+        if (!(w.pos.size() == n && w.vel.size() == n && w.kp.size() == n &&
+              w.kd.size() == n && w.tau.size() == n))
+            throw std::invalid_argument("Waypoint arrays must match the streamer ids length");
+        if (!std::isfinite(w.t))
+            throw std::invalid_argument("Waypoint time must be finite");
+        if (i > 0 && !(w.t > wps[i - 1].t))
+            throw std::invalid_argument("Waypoint times must be strictly increasing");
+    }
+
+    std::lock_guard<std::mutex> lk(load_m_);
+    if (ids_.size() != n)   // 검증 중 start() 로 대상 ids 가 바뀜
+        throw std::runtime_error("trajectory streamer restarted during load");
+    const double now = to_sec(Clock::now());
+    auto cur = std::atomic_load(&traj_);
+    auto next = std::make_shared<Trajectory>();
+
+    if (append && cur && !cur->wps.empty()) {
+        if (!wps.empty() && !(wps.front().t > cur->wps.back().t))
+            throw std::invalid_argument("Appended waypoints must start after the last waypoint");
+        next->t_base = cur->t_base;
+
+        // 이미 지나간 구간은 정리 (현재 구간의 시작 waypoint 는 유지)
+        const double t_now = now - cur->t_base;
+        size_t first = 0;
+        while (first + 1 < cur->wps.size() && cur->wps[first + 1].t <= t_now) ++first;
+        next->wps.reserve(cur->wps.size() - first + wps.size());
+        next->wps.insert(next->wps.end(), cur->wps.begin() + first, cur->wps.end());
+    } else {
+        next->t_base = now;
+    }
+    for (auto& w : wps) next->wps.push_back(std::move(w));
+
+    std::atomic_store(&traj_, std::shared_ptr<const Trajectory>(std::move(next)));
+}
+
+double FxTrajectoryStreamer::time() const {
+    auto cur = std::atomic_load(&traj_);
+    if (!cur) return 0.0;
+    return to_sec(Clock::now()) - cur->t_base;
+}
+
+bool FxTrajectoryStreamer::sample(double t, std::vector<float>& pos, std::vector<float>& vel,
+                                  std::vector<float>& kp, std::vector<float>& kd,
+                                  std::vector<float>& tau) const {
+    auto cur = std::atomic_load(&traj_);
+    if (!cur || cur->wps.empty()) return false;
+    size_t cursor = 0;
+    eval(*cur, interp_, t, cursor, pos, vel, kp, kd, tau);
+    return true;
+}
+
+FxTrajStats FxTrajectoryStreamer::stats() const {
+    std::lock_guard<std::mutex> lk(stats_m_);
+    return stats_;
+}
+
+void FxTrajectoryStreamer::eval(const Trajectory& tr, FxInterp interp, double t, size_t& cursor,
+                                std::vector<float>& pos, std::vector<float>& vel,
+                                std::vector<float>& kp, std::vector<float>& kd,
+                                std::vector<float>& tau) {
+    const auto& w = tr.wps;
+    const size_t n = w.front().pos.size();
+    pos.resize(n); vel.resize(n); kp.resize(n); kd.resize(n); tau.resize(n);
+
+    auto hold = [&](const FxWaypoint& p) {
+        pos = p.pos; vel = p.vel; kp = p.kp; kd = p.kd; tau = p.tau;
+    };
+    if (t <= w.front().t) { hold(w.front()); return; }
+    if (t >= w.back().t)  { hold(w.back());  return; }
+
+    // tick 마다 시간이 증가하므로 직전 구간부터 앞으로만 탐색
+    if (cursor >= w.size() - 1 || w[cursor].t > t) cursor = 0;
+    while (w[cursor + 1].t <= t) ++cursor;
+
+    const FxWaypoint& a = w[cursor];
+    const FxWaypoint& b = w[cursor + 1];
+    const double h = b.t - a.t;
+    const double s = (t - a.t) / h;
+
+    for (size_t i = 0; i < n; ++i) {
+        kp[i]  = lerp(a.kp[i],  b.kp[i],  s);
+        kd[i]  = lerp(a.kd[i],  b.kd[i],  s);
+        tau[i] = lerp(a.tau[i], b.tau[i], s);
+    }
+
+    if (interp == FxInterp::Linear) {
+        for (size_t i = 0; i < n; ++i) {
+            pos[i] = lerp(a.pos[i], b.pos[i], s);
+            vel[i] = lerp(a.vel[i], b.vel[i], s);
+        }
+        return;
+    }
+
+    // 3차 Hermite 기저와 그 미분
+    const double s2 = s * s, s3 = s2 * s;
+    const double h00 = 2 * s3 - 3 * s2 + 1, h10 = s3 - 2 * s2 + s;
+    const double h01 = -2 * s3 + 3 * s2,    h11 = s3 - s2;
+    const double d00 = 6 * s2 - 6 * s,      d10 = 3 * s2 - 4 * s + 1;
+    const double d01 = -6 * s2 + 6 * s,     d11 = 3 * s2 - 2 * s;
+    for (size_t i = 0; i < n; ++i) {
+        const double p0 = a.pos[i], p1 = b.pos[i];
+        const double m0 = a.vel[i] * h, m1 = b.vel[i] * h;
+        pos[i] = static_cast<float>(h00 * p0 + h10 * m0 + h01 * p1 + h11 * m1);
+        vel[i] = static_cast<float>((d00 * p0 + d10 * m0 + d01 * p1 + d11 * m1) / h);
+    }
+}
+
+void FxTrajectoryStreamer::loop() {
+    if (rt_priority_ > 0) {
+        struct sched_param sp{};
+        sp.sched_priority = rt_priority_;
+        ::pthread_setschedparam(::pthread_self(), SCHED_FIFO, &sp);   // 실패 시 일반 스케줄링 유지
+    }
+
+    const auto period = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(period_s_));
+    std::vector<float> pos, vel, kp, kd, tau;
+    std::shared_ptr<const Trajectory> cur;
+    size_t cursor = 0;
+
+    auto next = Clock::now();
+    while (run_.load()) {
+        next += period;
+        std::this_thread::sleep_until(next);
+
+        // 주기를 놓쳤으면 밀린 tick 은 건너뛰고 현재 시각에 맞춰 재정렬 (한꺼번에 몰아 보내지 않음)
+        const auto now = Clock::now();
+        const double late = std::chrono::duration<double>(now - next).count();
+        uint64_t skipped = 0;
+        if (now - next >= period) {
+            skipped = static_cast<uint64_t>((now - next) / period);
+            next += period * skipped;
+        }
+
+        auto tr = std::atomic_load(&traj_);
+        if (tr != cur) { cur = std::move(tr); cursor = 0; }
+        if (!cur || cur->wps.empty()) continue;
+
+        eval(*cur, interp_, to_sec(next) - cur->t_base, cursor, pos, vel, kp, kd, tau);
+
+        bool ok = true;
+        try {
+            emit_(ids_, pos, vel, kp, kd, tau);
+        } catch (const std::exception&) {
+            ok = false;
+        }
+
+        std::lock_guard<std::mutex> lk(stats_m_);
+        if (ok) stats_.ticks++;
+        else    stats_.send_errors++;
+        stats_.late_ticks += skipped;
+        if (late > stats_.max_lateness) stats_.max_lateness = late;
+    }
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 궤적 waypoint: 궤적 시각 t[s] + 모터별 MIT setpoint (각 배열 길이 = 스트리머 ids 수)
+struct FxWaypoint {
+  double t = 0.0;
+  std::vector<float> pos, vel, kp, kd, tau;
+};
+
+// 보간 방식
+//  - Linear      : 모든 필드 선형
+//  - CubicHermite: pos 는 vel 을 접선으로 하는 3차 Hermite, vel 은 그 미분, kp/kd/tau 선형
+enum class FxInterp { Linear, CubicHermite };
+
+struct FxTrajStats {
+  uint64_t ticks = 0;          // 송신한 setpoint 수
+  uint64_t late_ticks = 0;     // 주기를 1회 이상 놓쳐 건너뛴 tick 수
+  uint64_t send_errors = 0;    // 송신 실패 수
+  double   max_lateness = 0.0; // 예정 시각 대비 최대 지연 [s]
+};
+
+// 고주기 MIT setpoint 스트리머
+// - 자체 타이머 스레드에서 rate_hz 로 궤적을 보간하여 emit(ids, pos, vel, kp, kd, tau) 호출
+// - load(): 궤적 교체/추가를 원자적으로 반영 (실행 중 스레드는 다음 tick 부터 새 궤적 사용)
+//   * 교체(append=false): waypoint t 는 교체 시점 기준
+//   * 추가(append=true) : 기존 궤적과 같은 시간축, t 는 마지막 waypoint 이후여야 함
+// - 첫 waypoint 이전/마지막 waypoint 이후에는 양 끝 setpoint 유지(vel 은 Hermite 에서도 끝값 유지)
+class FxTrajectoryStreamer {
+public:
+  using EmitFn = std::function<void(const std::vector<uint8_t>&,
+                                    const std::vector<float>&,
+                                    const std::vector<float>&,
+                                    const std::vector<float>&,
+                                    const std::vector<float>&,
+                                    const std::vector<float>&)>;
+
+  explicit FxTrajectoryStreamer(EmitFn emit);
+  FxTrajectoryStreamer(const FxTrajectoryStreamer&) = delete;
+  FxTrajectoryStreamer& operator=(const FxTrajectoryStreamer&) = delete;
+  ~FxTrajectoryStreamer();
+
+  // 스트리밍 시작 (이미 실행 중이면 정지 후 재시작, 기존 궤적은 폐기)
+  //  - rt_priority > 0: SCHED_FIFO 우선순위 (권한 없으면 무시)
+  void start(const std::vector<uint8_t>& ids, double rate_hz,
+             FxInterp interp = FxInterp::CubicHermite, int rt_priority = 0);
+  void stop();
+  bool running() const { return run_.load(); }
+
+  // 궤적 교체/추가 (start 이후 호출, 잘못된 입력은 std::invalid_argument)
+  void load(std::vector<FxWaypoint> wps, bool append);
+
+  // 현재 궤적 시각 [s] (궤적 없으면 0)
+  double time() const;
+
+  // 궤적 시각 t 의 setpoint 계산 (스레드 미사용 경로, 스트리머 tick 과 동일 로직)
+  bool sample(double t, std::vector<float>& pos, std::vector<float>& vel,
+              std::vector<float>& kp, std::vector<float>& kd,
+              std::vector<float>& tau) const;
+
+  FxTrajStats stats() const;
+
+private:
+  struct Trajectory {
+    double t_base = 0.0;               // 궤적 t=0 의 host steady_clock [s]
+    std::vector<FxWaypoint> wps;
+  };
+
+  static void eval(const Trajectory& tr, FxInterp interp, double t, size_t& cursor,
+                   std::vector<float>& pos, std::vector<float>& vel,
+                   std::vector<float>& kp, std::vector<float>& kd,
+                   std::vector<float>& tau);
+  void loop();
+
+  EmitFn emit_;
+  std::vector<uint8_t> ids_;
+  double period_s_ = 0.001;
+  FxInterp interp_ = FxInterp::CubicHermite;
+  int rt_priority_ = 0;
+
+  std::shared_ptr<const Trajectory> traj_;   // std::atomic_load/store 로만 접근
+  std::mutex load_m_;                         // 교체/추가 + start() 설정 교체 직렬화 (스레드는 잡지 않음)
+
+  std::atomic<bool> run_{false};
+  std::thread th_;
+
+  mutable std::mutex stats_m_;
+  FxTrajStats stats_;
+};
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <string>
+
+// FxCli 하부 전송 계층 인터페이스
+// - 기본 구현은 UDP 소켓 + RX 스레드 (FxCli(ip, port) 가 내부에서 생성)
+// - FxCli(std::shared_ptr<FxTransport>) 로 다른 백엔드(예: FxSimMcu)를 꽂으면
+//   명령 인코딩/응답 매칭/파싱은 하드웨어와 같은 경로를 그대로 사용
+class FxTransport {
+public:
+  // 응답 1건 전달 (데이터, 도착 시각)
+  //  - RX 스레드에서 호출될 수도, send() 안에서 동기적으로 호출될 수도 있음
+  using RxFn = std::function<void(std::string&& data,
+                                  std::chrono::steady_clock::time_point t_arrival)>;
+
+  virtual ~FxTransport() = default;
+
+  // 수신 시작 (FxCli 생성 시 1회)
+  virtual void start(RxFn on_rx) = 0;
+
+  // 명령 1건 송신 (실패 시 std::runtime_error)
+  virtual void send(const char* data, size_t len) = 0;
+
+  // 수신 정지 (FxCli 소멸 시, 이후 on_rx 호출 없음)
+  virtual void stop() = 0;
+};
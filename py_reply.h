@@ -0,0 +1,84 @@
+// py_reply.h
+//
+// MCU 응답 문자열 -> Python dict 변환.
+// pybind_module.cpp 와 벤치마크(bench/fx_cli_bench.cpp)가 공유한다.
+// 파싱은 FxReply(fx_reply.h)가 담당하고, 여기서는 결과 트리를 dict 로 옮기기만 한다.
+
+#pragma once
+
+#include <pybind11/pybind11.h>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "fx_reply.h"
+#include "fx_trace.h"
+
+namespace py = pybind11;
+
+// head/subkey 문자열 캐시 (intern 된 str 재사용 → 매 응답마다 키 객체를 새로 만들지 않음)
+// - GIL 보유 상태에서만 호출
+// - 인터프리터 종료 후 소멸자가 돌지 않도록 의도적으로 해제하지 않음
+// - 펌웨어가 만드는 키 종류는 한정적이므로 상한을 넘으면 캐시 없이 생성
+static py::str intern_key(std::string_view k) {
+    static auto *cache = new std::unordered_map<std::string, py::str>();
+    static constexpr size_t kMaxKeys = 4096;
+    thread_local std::string probe;
+
+    probe.assign(k.data(), k.size());
+    auto it = cache->find(probe);
+    if (it != cache->end()) return it->second;
+
+    PyObject *o = PyUnicode_FromStringAndSize(k.data(), static_cast<Py_ssize_t>(k.size()));
+    if (!o) throw py::error_already_set();
+    PyUnicode_InternInPlace(&o);
+    py::str s = py::reinterpret_steal<py::str>(o);
+    if (cache->size() < kMaxKeys) cache->emplace(probe, s);
+    return s;
+}
+
+static py::object reply_value_to_py(const FxReply &r, const FxReply::Value &v) {
+    using V = FxReply::Value;
+    switch (v.type) {
+    case V::Bool:  return py::bool_(v.b);
+    case V::Int:   return py::int_(v.i);
+    case V::Float: return py::float_(v.f);
+    case V::Str: {
+        auto s = r.str(v);
+        return py::str(s.data(), s.size());
+    }
+    case V::List: {
+        auto items = r.list(v);
+        py::list arr(items.size());
+        size_t i = 0;
+        for (const auto &x : items) arr[i++] = reply_value_to_py(r, x);
+        return std::move(arr);
+    }
+    }
+    return py::none();
+}
+
+// FxReply -> dict
+//  {"OK <STATUS>": True, "MCU": {"fw": "1.1.0", ...}, "NET": {"state": "up", ...}, ...}
+static py::dict reply_to_dict(const FxReply &r) {
+    FX_TRACE_SPAN(py_dict);
+    py::dict result;
+    for (const auto &seg : r.segments()) {
+        py::str head = intern_key(r.head(seg));
+        if (seg.flag) {
+            result[head] = py::bool_(true);
+            continue;
+        }
+        py::dict head_dict;
+        for (const auto &f : r.fields(seg))
+            head_dict[intern_key(r.key(f))] = reply_value_to_py(r, f.value);
+        result[head] = std::move(head_dict);
+    }
+    return result;
+}
+
+// 문자열을 dict로 파싱
+// s: "STATUS;fw:1.1.0, proto:ATv1;uptime:28761;NET:up, ip:..., gw:..., mask:...;...;"
+static py::dict parse_response_string(const std::string &s) {
+    return reply_to_dict(FxReply::parse(s));
+}
@@ -2,6 +2,7 @@
 //
 // Python bindings for the FX CLI.
 // Exposes FxCli class, parsing MCU replies into Python dicts for ease of use.
+// Blocking calls release the GIL, so one FxCli can be shared across Python threads.
 
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
@@ -12,234 +13,13 @@
 #include <cstdint>
 
 #include "fx_client.h"
+#include "fx_sim.h"
+#include "fx_trace.h"
+#include "py_reply.h"
 
 namespace py = pybind11;
 
 
-// Trim helper
-static inline void trim(std::string &s) {
-    size_t start = s.find_first_not_of(" \t\n\r");
-    if (start == std::string::npos) { s.clear(); return; }
-    size_t end = s.find_last_not_of(" \t\n\r");
-    s = s.substr(start, end - start + 1);
-}
-
-// Split helper
-static std::vector<std::string> split(const std::string &s, char delim) {
-    std::vector<std::string> out;
-    std::string tmp;
-    std::istringstream iss(s);
-    while (std::getline(iss, tmp, delim)) {
-        trim(tmp);
-        if (!tmp.empty()) out.push_back(tmp);
-    }
-    return out;
-}
-
-static inline std::string upper_copy(std::string s) {
-    for (char &c : s) c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
-    return s;
-}
-
-// Try parse float
-static bool try_parse_float(const std::string &s, double &out) {
-    char *end = nullptr;
-    const char *cstr = s.c_str();
-    out = std::strtod(cstr, &end);
-    return !(end == cstr || *end != '\0');
-}
-
-// Try parse int
-static bool try_parse_int(const std::string &s, long &out) {
-    char *end = nullptr;
-    const char *cstr = s.c_str();
-    out = std::strtol(cstr, &end, 10);
-    return !(end == cstr || *end != '\0');
-}
-
-// 문자열을 dict로 파싱
-// s: "STATUS;fw:1.1.0, proto:ATv1;uptime:28761;NET:up, ip:..., gw:..., mask:...;...;"
-static py::dict parse_response_string(const std::string &s) {
-    py::dict result;
-    std::string str = s;
-    trim(str);
-
-    auto segments = split(str, ';'); // 세미콜론 단위
-    for (auto &seg : segments) {
-        trim(seg);
-        if (seg.empty()) continue;
-
-        size_t first_colon = seg.find(':');
-        if (first_colon == std::string::npos) {
-            // "STATUS;" / "OBS;" 같은 단독 토큰
-            result[py::str(seg)] = py::bool_(true);
-            continue;
-        }
-
-        std::string head = seg.substr(0, first_colon);
-        std::string rest = seg.substr(first_colon + 1);
-        trim(head); trim(rest);
-
-        if (head.empty()) continue;
-        if (rest.empty()) { // "ERRS[latest]:" 처럼 값이 비어있는 케이스
-            result[py::str(head)] = py::bool_(true);
-            continue;
-        }
-
-        // HEAD dict 준비
-        py::dict head_dict;
-        // ---- 스캐닝 유틸 ----
-        auto eat_ws = [&](size_t &i) {
-            while (i < rest.size() && (rest[i]==' ' || rest[i]=='\t')) ++i;
-        };
-        auto is_ident_char = [&](char c)->bool {
-            return std::isalnum((unsigned char)c) || c=='_' || c=='[' || c==']';
-        };
-
-        size_t p = 0;
-        bool first_item = true;
-        while (p < rest.size()) {
-            eat_ws(p);
-            if (p >= rest.size()) break;
-
-            // 콤마 구분자 스킵
-            if (rest[p] == ',') { ++p; continue; }
-            eat_ws(p);
-            if (p >= rest.size()) break;
-
-            // 시도1: subkey:value 형태인지 체크
-            size_t save = p;
-            // subkey 후보 스캔 (식별자)
-            size_t k_end = p;
-            while (k_end < rest.size() && is_ident_char(rest[k_end])) ++k_end;
-
-            bool has_pair = false;
-            if (k_end < rest.size() && rest[k_end] == ':') {
-                has_pair = true;
-            }
-
-            if (!has_pair) {
-                // subkey 없이 bare value
-                size_t v_start = p;
-                size_t boundary = std::string::npos;
-                size_t search = p;
-                while (true) {
-                    size_t comma = rest.find(',', search);
-                    if (comma == std::string::npos) break;
-                    size_t look = comma + 1;
-                    eat_ws(look);
-                    // 다음이 식별자 + ':' 이면 그 콤마가 경계
-                    size_t t = look;
-                    while (t < rest.size() && is_ident_char(rest[t])) ++t;
-                    if (t > look && t < rest.size() && rest[t] == ':') {
-                        boundary = comma;
-                        break;
-                    }
-                    search = comma + 1;
-                }
-                size_t v_end = (boundary == std::string::npos) ? rest.size() : boundary;
-                std::string v = rest.substr(v_start, v_end - v_start);
-                trim(v);
-
-                if (!v.empty()) {
-                    std::string vu = upper_copy(v);
-                    const bool is_state = (vu == "UP" || vu == "DOWN");
-                    if (is_state) {
-                        head_dict[py::str("state")] = py::str(v);
-                    } else {
-                        double dv;
-                        long iv;
-                        if (v.find('.') == std::string::npos && try_parse_int(v, iv))
-                            head_dict[py::str("value")] = py::int_(iv);
-                        else if (try_parse_float(v, dv))
-                            head_dict[py::str("value")] = py::float_(dv);
-                        else
-                            head_dict[py::str("value")] = py::str(v);
-                    }
-                }
-
-                if (v_end == rest.size()) { p = v_end; break; }
-                p = v_end + 1; // 콤마 다음으로
-                first_item = false;
-                continue;
-            }
-
-            // subkey:value 처리
-            std::string subkey = rest.substr(p, k_end - p);
-            trim(subkey);
-            p = k_end + 1; // ':' 넘김
-            eat_ws(p);
-            size_t v_start = p;
-
-            // value 경계: 다음 ",<ident>:" 패턴의 콤마 직전
-            size_t boundary = std::string::npos;
-            size_t search = p;
-            while (true) {
-                size_t comma = rest.find(',', search);
-                if (comma == std::string::npos) break;
-                size_t look = comma + 1;
-                eat_ws(look);
-                size_t t = look;
-                while (t < rest.size() && is_ident_char(rest[t])) ++t;
-                if (t > look && t < rest.size() && rest[t] == ':') {
-                    boundary = comma;
-                    break;
-                }
-                search = comma + 1;
-            }
-            size_t v_end = (boundary == std::string::npos) ? rest.size() : boundary;
-            std::string value_str = rest.substr(v_start, v_end - v_start);
-            trim(value_str);
-
-            if (!value_str.empty()) {
-                if (value_str.find(',') != std::string::npos) {
-                    // 값 내부에 콤마 → 리스트
-                    py::list arr;
-                    size_t q = 0;
-                    while (q < value_str.size()) {
-                        size_t c = value_str.find(',', q);
-                        std::string token = (c == std::string::npos)
-                            ? value_str.substr(q)
-                            : value_str.substr(q, c - q);
-                        trim(token);
-                        double dv;
-                        long iv;
-                        if (token.find('.') == std::string::npos && try_parse_int(token, iv))
-                            arr.append(py::int_(iv));
-                        else if (try_parse_float(token, dv))
-                            arr.append(py::float_(dv));
-                        else
-                            arr.append(py::str(token));
-                        if (c == std::string::npos) break;
-                        q = c + 1;
-                    }
-                    head_dict[py::str(subkey)] = arr;
-                } else {
-                    double dv;
-                    long iv;
-                    if (value_str.find('.') == std::string::npos && try_parse_int(value_str, iv))
-                        head_dict[py::str(subkey)] = py::int_(iv);
-                    else if (try_parse_float(value_str, dv))
-                        head_dict[py::str(subkey)] = py::float_(dv);
-                    else
-                        head_dict[py::str(subkey)] = py::str(value_str);
-                }
-            } else {
-                head_dict[py::str(subkey)] = py::bool_(true);
-            }
-
-            if (v_end == rest.size()) { p = v_end; break; }
-            p = v_end + 1;
-            first_item = false;
-        }
-
-        result[py::str(head)] = head_dict;
-    }
-
-    return result;
-}
-
-
 // Parse list of motor IDs
 static std::vector<uint8_t> parse_id_list(const py::object &obj) {
     std::vector<uint8_t> ids;
@@ -254,42 +34,175 @@ static std::vector<uint8_t> parse_id_list(const py::object &obj) {
     return ids;
 }
 
+// "linear" / "cubic" -> FxInterp
+static FxInterp parse_interp(const std::string &name) {
+    if (name == "linear") return FxInterp::Linear;
+    if (name == "cubic" || name == "hermite") return FxInterp::CubicHermite;
+    throw std::invalid_argument("interp must be 'linear' or 'cubic'");
+}
+
+// [{"t":0.0, "pos":[...], "vel":[...], "kp":[...], "kd":[...], "tau":[...]}, ...] -> waypoints
+static std::vector<FxWaypoint> parse_waypoints(const py::list &lst) {
+    std::vector<FxWaypoint> wps;
+    wps.reserve(lst.size());
+    for (auto &item : lst) {
+        py::dict d = item.cast<py::dict>();
+        FxWaypoint w;
+        w.t   = d["t"].cast<double>();
+        w.pos = d["pos"].cast<std::vector<float>>();
+        w.vel = d["vel"].cast<std::vector<float>>();
+        w.kp  = d["kp"].cast<std::vector<float>>();
+        w.kd  = d["kd"].cast<std::vector<float>>();
+        w.tau = d["tau"].cast<std::vector<float>>();
+        wps.push_back(std::move(w));
+    }
+    return wps;
+}
+
+// {"port":0, "rcvbuf":..., "max_queue":..., "rx_priority":0, "so_priority":0} -> 채널 설정
+//  - 생략된 키는 opt 의 기본값 유지
+static FxChannelOptions parse_channel_options(const py::object &obj, FxChannelOptions opt) {
+    if (obj.is_none()) return opt;
+    py::dict d = obj.cast<py::dict>();
+    for (auto kv : d) {
+        const std::string k = kv.first.cast<std::string>();
+        if      (k == "port")        opt.port        = kv.second.cast<uint16_t>();
+        else if (k == "rcvbuf")      opt.rcvbuf      = kv.second.cast<int>();
+        else if (k == "max_queue")   opt.max_queue   = kv.second.cast<size_t>();
+        else if (k == "rx_priority") opt.rx_priority = kv.second.cast<int>();
+        else if (k == "so_priority") opt.so_priority = kv.second.cast<int>();
+        else throw std::invalid_argument("unknown channel option: " + k);
+    }
+    return opt;
+}
+
+// FxTiming -> dict
+static py::dict timing_to_dict(const FxTiming &t) {
+    py::dict d;
+    d["valid"]     = t.valid;
+    d["synced"]    = t.synced;
+    d["estimated"] = t.estimated;
+    d["t_send"]    = t.t_send;
+    d["t_arrival"] = t.t_arrival;
+    d["rtt"]       = t.rtt;
+    d["mcu_time"]  = t.mcu_time;
+    d["t_sample"]  = t.t_sample;
+    d["latency"]   = t.latency;
+    return d;
+}
+
 PYBIND11_MODULE(fx_cli, m) {
     m.doc() = "High level FX motor controller client using UDP AT commands";
 
+    // span 트레이싱 (Chrome trace JSON)
+    m.def("trace_enable", &fx_trace::enable, py::arg("on") = true);
+    m.def("trace_enabled", &fx_trace::enabled);
+    m.def("trace_clear", &fx_trace::clear);
+    m.def("trace_set_buffer_capacity", &fx_trace::set_buffer_capacity, py::arg("spans"));
+    m.def("trace_dropped", &fx_trace::dropped);
+    m.def("trace_json", &fx_trace::chrome_json);
+    m.def("trace_dump", &fx_trace::dump, py::arg("path"));
+
+    // 전송 계층 (FxCli(transport) 생성자용 기반 타입)
+    py::class_<FxTransport, std::shared_ptr<FxTransport>>(m, "FxTransport");
+
+    // 인프로세스 MCU 시뮬레이터: FxCli(sim) 으로 연결, sim.step() 으로 물리 진행 (lockstep)
+    py::class_<FxSimMcu, FxTransport, std::shared_ptr<FxSimMcu>>(m, "FxSim")
+        .def(py::init<double>(), py::arg("dt") = 0.001)
+        .def("add_motor", [](FxSimMcu &self, int id, double inertia, double damping, double tau_max) {
+            if (id < 0 || id > 255) throw std::out_of_range("ID out of range 0..255");
+            FxSimMotorParams p;
+            p.inertia = inertia;
+            p.damping = damping;
+            p.tau_max = tau_max;
+            self.add_motor(static_cast<uint8_t>(id), p);
+        }, py::arg("id"), py::arg("inertia") = 0.01, py::arg("damping") = 0.02, py::arg("tau_max") = 10.0)
+        .def("step", &FxSimMcu::step, py::arg("n") = 1, py::call_guard<py::gil_scoped_release>())
+        .def("motor", [](const FxSimMcu &self, uint8_t id) {
+            FxSimMotorState st = self.motor(id);
+            py::dict d;
+            d["pos"]     = st.pos;
+            d["vel"]     = st.vel;
+            d["tau"]     = st.tau;
+            d["enabled"] = st.enabled;
+            return d;
+        }, py::arg("id"))
+        .def("set_motor", &FxSimMcu::set_motor, py::arg("id"), py::arg("pos"), py::arg("vel") = 0.0)
+        .def("reset", &FxSimMcu::reset)
+        .def("drop_replies", &FxSimMcu::drop_replies, py::arg("tag"), py::arg("n") = 1)
+        .def("time", &FxSimMcu::time)
+        .def("steps", &FxSimMcu::steps)
+        .def_property_readonly("dt", &FxSimMcu::dt);
+
     py::class_<FxCli>(m, "FxCli")
         .def(py::init<const std::string&, uint16_t>(),
              py::arg("ip"),
              py::arg("port"))
+        .def(py::init<std::shared_ptr<FxTransport>>(),
+             py::arg("transport"))
+        // 제어(MIT/REQ)/관리(START/STOP/STATUS/...) 채널 분리
+        .def(py::init([](const std::string &ip, uint16_t port,
+                         const py::object &realtime, const py::object &management) {
+            FxChannelConfig ch;
+            ch.realtime   = parse_channel_options(realtime, ch.realtime);
+            ch.management = parse_channel_options(management, ch.management);
+            return new FxCli(ip, port, ch);
+        }), py::arg("ip"), py::arg("port"),
+            py::arg("realtime") = py::none(), py::arg("management") = py::none())
         .def("mcu_ping", [](FxCli &self) {
-            std::string resp = self.mcu_ping();
+            std::string resp;
+            { py::gil_scoped_release nogil; resp = self.mcu_ping(); }
             return parse_response_string(resp); // dict
         })
         .def("mcu_whoami", [](FxCli &self) {
-            std::string resp = self.mcu_whoami();
+            std::string resp;
+            { py::gil_scoped_release nogil; resp = self.mcu_whoami(); }
             return parse_response_string(resp); // dict
         })
         .def("motor_start", [](FxCli &self, const py::object &ids_obj) {
             auto ids = parse_id_list(ids_obj);
+            py::gil_scoped_release nogil;
             return self.motor_start(ids); // bool
         }, py::arg("ids"))
 
         .def("motor_stop", [](FxCli &self, const py::object &ids_obj) {
             auto ids = parse_id_list(ids_obj);
+            py::gil_scoped_release nogil;
             return self.motor_stop(ids); // bool
         }, py::arg("ids"))
 
         .def("motor_estop", [](FxCli &self, const py::object &ids_obj) {
             auto ids = parse_id_list(ids_obj);
+            py::gil_scoped_release nogil;
             return self.motor_estop(ids); // bool
         }, py::arg("ids"))
 
+        // STOP/ESTOP 우선 송신 경로
+        .def("safety_arm", [](FxCli &self, const py::object &ids_obj) {
+            auto ids = parse_id_list(ids_obj);
+            self.safety_arm(ids);
+        }, py::arg("ids"))
+
+        .def("safety_stats", [](const FxCli &self) {
+            FxSafetyStats st = self.safety_stats();
+            py::dict d;
+            d["sent"]              = st.sent;
+            d["resent"]            = st.resent;
+            d["acked"]             = st.acked;
+            d["last_send_latency"] = st.last_send_latency;
+            d["max_send_latency"]  = st.max_send_latency;
+            d["last_ack_rtt"]      = st.last_ack_rtt;
+            return d;
+        })
+
         .def("motor_setzero", [](FxCli &self, const py::object &ids_obj) {
             auto ids = parse_id_list(ids_obj);
+            py::gil_scoped_release nogil;
             return self.motor_setzero(ids); // bool
         }, py::arg("ids"))
 
         .def("operation_control", [](FxCli &self, const py::list &groups) {
+            FX_TRACE_SPAN(py_operation_control);
             std::vector<uint8_t> ids; std::vector<float> pos, vel, kp, kd, tau;
             for (auto &item : groups) {
                 py::dict d = item.cast<py::dict>();
@@ -301,17 +214,95 @@ PYBIND11_MODULE(fx_cli, m) {
                 kd.push_back(d["kd"].cast<float>());
                 tau.push_back(d["tau"].cast<float>());
             }
+            py::gil_scoped_release nogil;
             return self.operation_control(ids, pos, vel, kp, kd, tau);
         }, py::arg("groups"))
 
-        .def("req", [](FxCli &self, const py::object &ids_obj) {
+        // MIT delta 인코딩 (AT+MITD, 바뀐 필드만 송신)
+        .def("mit_delta", [](FxCli &self, bool enable, int refresh_every) {
+            self.mit_delta(enable, refresh_every);
+        }, py::arg("enable") = true, py::arg("refresh_every") = 50)
+
+        // 궤적 스트리밍 (C++ 스레드에서 rate_hz 로 보간된 AT+MIT 송신)
+        .def("traj_start", [](FxCli &self, const py::object &ids_obj, double rate_hz,
+                              const std::string &interp, int rt_priority) {
             auto ids = parse_id_list(ids_obj);
-            std::string resp = self.req(ids);
-            return parse_response_string(resp); // dict
-        }, py::arg("ids"))
+            FxInterp mode = parse_interp(interp);
+            py::gil_scoped_release nogil;
+            self.traj_start(ids, rate_hz, mode, rt_priority);
+        }, py::arg("ids"), py::arg("rate_hz") = 1000.0,
+           py::arg("interp") = "cubic", py::arg("rt_priority") = 0)
+
+        .def("traj_load", [](FxCli &self, const py::list &waypoints, bool append) {
+            auto wps = parse_waypoints(waypoints);
+            py::gil_scoped_release nogil;
+            self.traj_load(wps, append);
+        }, py::arg("waypoints"), py::arg("append") = false)
+
+        .def("traj_stop", &FxCli::traj_stop, py::call_guard<py::gil_scoped_release>())
+        .def("traj_running", &FxCli::traj_running)
+        .def("traj_time", &FxCli::traj_time)
+        .def("traj_stats", [](const FxCli &self) {
+            FxTrajStats st = self.traj_stats();
+            py::dict d;
+            d["ticks"]        = st.ticks;
+            d["late_ticks"]   = st.late_ticks;
+            d["send_errors"]  = st.send_errors;
+            d["max_lateness"] = st.max_lateness;
+            return d;
+        })
+
+        .def("req", [](FxCli &self, const py::object &ids_obj, bool with_timing) {
+            FX_TRACE_SPAN(py_req);
+            auto ids = parse_id_list(ids_obj);
+            FxReply r;
+            FxTiming timing;
+            { py::gil_scoped_release nogil; r = self.req_reply(ids, &timing); }   // 파싱까지 GIL 밖에서
+            py::dict d = reply_to_dict(r); // dict
+            if (with_timing && !r.text().empty())
+                d["TIMING"] = timing_to_dict(timing);
+            return d;
+        }, py::arg("ids"), py::arg("with_timing") = false)
 
         .def("status", [](FxCli &self) {
-            std::string resp = self.status();
-            return parse_response_string(resp); // dict
-        });
+            FX_TRACE_SPAN(py_status);
+            FxReply r;
+            { py::gil_scoped_release nogil; r = self.status_reply(); }
+            return reply_to_dict(r); // dict
+        })
+
+        // 시계 동기 / 지연 보상 (시각 기준: time.monotonic())
+        .def("last_timing", [](const FxCli &self) {
+            return timing_to_dict(self.last_timing());
+        })
+        .def("clock_sync", [](const FxCli &self) {
+            FxClockSyncState st = self.clock_sync();
+            py::dict d;
+            d["synced"]    = st.synced;
+            d["samples"]   = st.samples;
+            d["offset"]    = st.offset;
+            d["drift_ppm"] = st.drift_ppm;
+            d["min_rtt"]   = st.min_rtt;
+            d["last_rtt"]  = st.last_rtt;
+            return d;
+        })
+        .def("clock_sync_reset", &FxCli::clock_sync_reset)
+        .def_static("host_time", &FxCli::host_time)
+
+        // MCU 탐색: [{"ip", "port", "rtt", "ping", "whoami": dict}, ...] (첫 응답 도착 순)
+        .def_static("discover", [](const std::vector<std::string> &addrs, uint16_t port, int timeout_ms) {
+            std::vector<FxEndpoint> found;
+            { py::gil_scoped_release nogil; found = FxCli::discover(addrs, port, timeout_ms); }
+            py::list out;
+            for (const auto &ep : found) {
+                py::dict d;
+                d["ip"]     = ep.ip;
+                d["port"]   = ep.port;
+                d["rtt"]    = ep.rtt;
+                d["ping"]   = ep.ping;
+                d["whoami"] = reply_to_dict(ep.whoami);
+                out.append(d);
+            }
+            return out;
+        }, py::arg("addrs"), py::arg("port"), py::arg("timeout_ms") = 200);
 }
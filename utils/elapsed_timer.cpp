@@ -4,17 +4,28 @@
 ElapsedTimer::ElapsedTimer(const std::string& timername) : timername(timername) {}
 
 void ElapsedTimer::startTimer() {
-    start_time = std::chrono::high_resolution_clock::now();
+    auto now = std::chrono::high_resolution_clock::now();
+    std::lock_guard<std::mutex> lk(m_);
+    start_times[std::this_thread::get_id()] = now;
 }
 
 void ElapsedTimer::stopTimer() {
     auto end_time = std::chrono::high_resolution_clock::now();
-    std::chrono::duration<double> elapsed = end_time - start_time;
-    elapsed_times.push_back(elapsed.count() * 1000.0);
-    std::cout << "[Timer|" << timername << "] Elapsed: " << elapsed.count() * 1000.0 << " ms" << std::endl;
+    double ms;
+    {
+        std::lock_guard<std::mutex> lk(m_);
+        auto it = start_times.find(std::this_thread::get_id());
+        if (it == start_times.end()) return;   // startTimer 없이 호출
+        std::chrono::duration<double> elapsed = end_time - it->second;
+        start_times.erase(it);
+        ms = elapsed.count() * 1000.0;
+        elapsed_times.push_back(ms);
+    }
+    std::cout << "[Timer|" << timername << "] Elapsed: " << ms << " ms" << std::endl;
 }
 
 void ElapsedTimer::printStatistics() const {
+    std::lock_guard<std::mutex> lk(m_);
     if (elapsed_times.empty()) {
         std::cerr << "[Timer|" << timername << "] No elapsed times recorded." << std::endl;
         return;
@@ -28,4 +39,4 @@ void ElapsedTimer::printStatistics() const {
 
     std::cout << "[Timer|" << timername << "] Mean elapsed time: " << mean << " ms" << std::endl;
     std::cout << "[Timer|" << timername << "] Std of elapsed time: " << stdev << " ms" << std::endl;
-}
\ No newline at end of file
+}
@@ -5,7 +5,13 @@
 #include <iostream>
 #include <numeric>
 #include <cmath>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 
+// 구간 시간 측정 + 평균/표준편차 통계
+// - 스레드 안전: 시작 시각은 스레드별로 보관, 측정값 누적은 mutex 로 보호
+//   (여러 스레드가 같은 인스턴스로 start/stop 해도 각자의 구간을 측정)
 class ElapsedTimer {
 public:
     explicit ElapsedTimer(const std::string& timername);
@@ -16,6 +22,7 @@ public:
 
 private:
     std::string timername;
-    std::chrono::high_resolution_clock::time_point start_time;
+    mutable std::mutex m_;
+    std::unordered_map<std::thread::id, std::chrono::high_resolution_clock::time_point> start_times;
     std::vector<double> elapsed_times;
 };